@@ -0,0 +1,49 @@
+#version 330 core
+
+/////////////////////////////////////////////////////////////
+//////////////////////// ATTRIBUTES /////////////////////////
+/////////////////////////////////////////////////////////////
+layout(location = 0) in vec3 a_vertexPosition;
+layout(location = 1) in vec3 a_vertexNormal;
+layout(location = 2) in vec2 a_vertexTextureCoord;
+layout(location = 3) in vec3 a_vertexTangent;
+layout(location = 4) in vec3 a_vertexBitangent;
+layout(location = 5) in vec3 a_vertexColor;
+
+// Per-instance transform as the three rows of a 3x4 affine matrix
+layout(location = 6) in vec4 a_instanceRow0;
+layout(location = 7) in vec4 a_instanceRow1;
+layout(location = 8) in vec4 a_instanceRow2;
+
+/////////////////////////////////////////////////////////////
+//////////////////////// UNIFORMS ///////////////////////////
+/////////////////////////////////////////////////////////////
+uniform mat4 u_model;
+uniform mat4 u_local;
+uniform mat4 u_view;
+uniform mat4 u_projection;
+
+/////////////////////////////////////////////////////////////
+///////////////////////// VARYING ///////////////////////////
+/////////////////////////////////////////////////////////////
+out vec3 v_color;
+out vec2 v_texCoord;
+out vec3 v_fragPos;
+out vec3 v_fragCameraPos;
+
+/////////////////////////////////////////////////////////////
+////////////////////////// MAIN /////////////////////////////
+/////////////////////////////////////////////////////////////
+void main() {
+    mat4 instance = transpose(mat4(a_instanceRow0, a_instanceRow1, a_instanceRow2, vec4(0.0, 0.0, 0.0, 1.0)));
+
+    vec4 worldPosition = u_model * instance * u_local * vec4(a_vertexPosition, 1.0);
+    vec4 cameraPosition = u_view * worldPosition;
+
+    v_color = a_vertexColor;
+    v_texCoord = a_vertexTextureCoord;
+    v_fragPos = vec3(worldPosition);
+    v_fragCameraPos = vec3(cameraPosition);
+
+    gl_Position = u_projection * cameraPosition;
+}
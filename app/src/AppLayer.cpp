@@ -4,7 +4,29 @@
 #include <glm/gtx/quaternion.hpp>
 #include <glm/mat4x4.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <iostream>
+
+namespace {
+
+Engine::BoundingBox modelBounds(const Engine::Model &model) {
+    Engine::BoundingBox bounds;
+    bool first = true;
+    for (const auto &mesh : model.meshes) {
+        if (mesh.vertices.empty()) {
+            continue;
+        }
+
+        Engine::BoundingBox meshBounds = Engine::BoundingBox::fromVertices(mesh.vertices);
+        bounds.min = first ? meshBounds.min : glm::min(bounds.min, meshBounds.min);
+        bounds.max = first ? meshBounds.max : glm::max(bounds.max, meshBounds.max);
+        first = false;
+    }
+    return bounds;
+}
+
+} // namespace
 
 void AppLayer::onAttach() {
     auto& app = Engine::Application::get();
@@ -16,22 +38,39 @@ void AppLayer::onAttach() {
     auto fragmentSrc = Engine::File::read("./assets/shaders/fill.fragment.glsl");
 
     m_Shader = Engine::Shader(vertexSrc, fragmentSrc);
+
+    auto instancedVertexSrc = Engine::File::read("./assets/shaders/vertex.instanced.glsl");
+    m_InstancedShader = Engine::Shader(instancedVertexSrc, fragmentSrc);
     
+    // Both models are drawn with the fill shaders, which read little more than positions.
+    Engine::VertexLayout layout = Engine::VertexLayout::compact();
+
     m_GeometryModel = Engine::ModelLoader::loadObj("./assets/models/arrow.obj");
+    m_GeometryModel->setLayout(layout);
     m_GeometryModel->setUp();
     m_GeometryTransform = glm::scale(m_GeometryTransform, glm::vec3(4.0f, 4.0f, 4.0f));
+    m_GeometryBounds = modelBounds(*m_GeometryModel);
 
     m_ParticleModel = Engine::ModelLoader::loadObj("./assets/models/bug.obj");
+    m_ParticleModel->setLayout(layout);
     m_ParticleModel->setUp();
     m_ParticleTransform = glm::scale(glm::mat4(1.0f), glm::vec3(0.01f, 0.01f, 0.01f));
 
+    // The particle basis rotates the model about its origin, so the farthest
+    // bounding box corner bounds it in every orientation.
+    Engine::BoundingBox particleBounds = modelBounds(*m_ParticleModel);
+    m_ParticleRadius = glm::length(glm::max(glm::abs(particleBounds.min), glm::abs(particleBounds.max))) * 0.01f;
+
     camera.setPosition(glm::vec3(8.0f, 6.0f, 8.0f));
     camera.setRotation(glm::quat(glm::vec3(glm::radians(-25.0f), glm::radians(45.0f), 0.0f)));
 
-    for (size_t i = 0; i < 200; i++) {
-        m_Particles.emplace_back(m_GeometryModel->meshes[0]);
-        m_Particles[m_Particles.size() - 1].setUp();
-    }
+    m_Particles = std::make_unique<Engine::SurfaceParticleSystem>(m_GeometryModel->meshes[0]);
+    m_Particles->spawn(200);
+
+    std::cout << "Particles: " << m_Particles->size() << ", " << m_Particles->bytesPerParticle()
+              << " bytes per particle" << std::endl;
+    std::cout << "GPU buffers: " << Engine::GpuResources::getTotals(Engine::GpuResources::Buffer).bytes << " bytes"
+              << std::endl;
  }
 
 void AppLayer::onUpdate() { 
@@ -71,29 +110,52 @@ void AppLayer::onUpdate() {
         cameraController.move(delta, 0.1);
     }
 
-    for (auto& particle : m_Particles) {
-        particle.update();
-    }
-
     m_Shader.bind();
     m_Shader.setMatrix4("u_view", camera.viewMatrix());
     m_Shader.setMatrix4("u_projection", camera.projectionMatrix());
     m_Shader.setFloat3("u_lightPos", glm::vec3(8.0f, 4.0f, 4.0f));
 
+    m_InstancedShader.bind();
+    m_InstancedShader.setMatrix4("u_view", camera.viewMatrix());
+    m_InstancedShader.setMatrix4("u_projection", camera.projectionMatrix());
+    m_InstancedShader.setFloat3("u_lightPos", glm::vec3(8.0f, 4.0f, 4.0f));
+
     m_GeometryTransform = glm::rotate(glm::mat4(1.0f), 0.01f, glm::vec3(0.0f, 0.0f, 1.0f)) * m_GeometryTransform;
 }
 
+void AppLayer::onFixedUpdate() {
+    auto &app = Engine::Application::get();
+    m_Particles->update(static_cast<float>(app.getTime().getFixedStep()), app.getJobPool());
+}
+
 void AppLayer::onDraw() { 
-    m_Shader.bind();
-    m_Shader.setMatrix4("u_model", m_GeometryTransform);
-    m_Shader.setFloat4("u_color", glm::vec4(0.25f, 0.75f, 0.1f, 1.0f));
-    m_GeometryModel->draw();
-
-    for (auto& particle : m_Particles) {
-        m_Shader.setMatrix4("u_model", m_GeometryTransform * particle.getTransform() * m_ParticleTransform);
-        m_Shader.setFloat4("u_color", glm::vec4(0.25f, 0.25f, 0.25f, 1.0f));
-        m_ParticleModel->draw();
+    auto &app = Engine::Application::get();
+    auto &time = app.getTime();
+
+    // Cull in the host model's space, where both the mesh and the particles live.
+    auto frustum = Engine::Frustum::fromMatrix(app.getCamera().viewProjectionMatrix() * m_GeometryTransform);
+
+    if (frustum.intersectsBox(m_GeometryBounds)) {
+        m_Shader.bind();
+        m_Shader.setMatrix4("u_model", m_GeometryTransform);
+        m_Shader.setFloat4("u_color", glm::vec4(0.25f, 0.75f, 0.1f, 1.0f));
+        m_GeometryModel->draw();
     }
+
+    // Particles are drawn between their last two positions, so widen the test by one step.
+    float radius = m_ParticleRadius + m_Particles->getSpeed() * static_cast<float>(time.getFixedStep());
+    size_t visible = m_Particles->cull(frustum, radius, m_VisibleParticles);
+
+    m_ParticleInstances.resize(visible * Engine::Mesh::c_InstanceFloats);
+    m_Particles->writeTransforms(m_ParticleInstances.data(), static_cast<float>(time.getInterpolation()),
+                                 m_VisibleParticles);
+    m_ParticleModel->setInstances(m_ParticleInstances.data(), visible);
+
+    m_InstancedShader.bind();
+    m_InstancedShader.setMatrix4("u_model", m_GeometryTransform);
+    m_InstancedShader.setMatrix4("u_local", m_ParticleTransform);
+    m_InstancedShader.setFloat4("u_color", glm::vec4(0.25f, 0.25f, 0.25f, 1.0f));
+    m_ParticleModel->drawInstanced(visible);
 }
 
 void AppLayer::onDetach() { }
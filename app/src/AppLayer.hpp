@@ -1,27 +1,33 @@
 #pragma once
 
 #include "Engine.hpp"
-#include "GeometryParticle.hpp"
 
 #include <glm/mat4x4.hpp>
+#include <memory>
 #include <vector>
 
 class AppLayer : public Engine::Layer {
   private:
     Engine::Shader m_Shader;
+    Engine::Shader m_InstancedShader;
 
     std::shared_ptr<Engine::Model> m_GeometryModel;
     glm::mat4 m_GeometryTransform = glm::mat4(1.0f);
+    Engine::BoundingBox m_GeometryBounds;
 
     std::shared_ptr<Engine::Model> m_ParticleModel;
     glm::mat4 m_ParticleTransform = glm::mat4(1.0f);
+    float m_ParticleRadius = 0.0f;
 
-    std::vector<GeometryParticle> m_Particles;
+    std::unique_ptr<Engine::SurfaceParticleSystem> m_Particles;
+    std::vector<uint32_t> m_VisibleParticles;
+    std::vector<float> m_ParticleInstances;
 
   public:
     using Layer::Layer;
 
     virtual void onAttach() override;
+    virtual void onFixedUpdate() override;
     virtual void onUpdate() override;
     virtual void onDraw() override;
     virtual void onDetach() override;
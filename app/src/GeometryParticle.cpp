@@ -88,7 +88,22 @@ void GeometryParticle::moveToNextTriangle() {
   int index2;
   glm::vec3 displacement;
 
-  if (m_Geometry.indices.size() > 0) {
+  if (!m_Geometry.topology.empty()) {
+    auto result = findAdjacentTriangle(m_Geometry.topology);
+    triangle = result.first;
+
+    if (triangle < 0) {
+      m_Velocity *= -1.0f;
+      return;
+    }
+
+    index0 = m_Geometry.topology.corner(triangle, 0);
+    index1 = m_Geometry.topology.corner(triangle, 1);
+    index2 = m_Geometry.topology.corner(triangle, 2);
+
+    displacement = result.second;
+
+  } else if (m_Geometry.indices.size() > 0) {
     auto result = findNextIndexedTriangle(m_Geometry);
     triangle = result.first;
 
@@ -136,6 +151,30 @@ void GeometryParticle::moveToNextTriangle() {
   m_TriangleIndex = triangle;
 }
 
+std::pair<int, glm::vec3> GeometryParticle::findAdjacentTriangle(const Engine::MeshTopology& topology) {
+  const glm::vec3 corners[3] = {m_P0, m_P1, m_P2};
+  glm::vec3 N = getTriangleNormal(m_P0, m_P1, m_P2);
+  glm::vec3 target = m_Position + m_Velocity * m_Speed;
+
+  // The crossed edge is the one the target point lies furthest outside of.
+  float minDistance = std::numeric_limits<float>::max();
+  int exitEdge = 0;
+
+  for (int edge = 0; edge < 3; edge++) {
+    glm::vec3 edgeStart = corners[edge];
+    glm::vec3 edgeDir = glm::normalize(corners[(edge + 1) % 3] - edgeStart);
+    float distance = glm::dot(glm::cross(edgeDir, target - edgeStart), N);
+
+    if (minDistance > distance) {
+      minDistance = distance;
+      exitEdge = edge;
+    }
+  }
+
+  glm::vec3 displacement = getDisplacementToLine(corners[exitEdge], corners[(exitEdge + 1) % 3], m_Position);
+  return std::make_pair(topology.neighbor(m_TriangleIndex, exitEdge), displacement);
+}
+
 std::pair<int, glm::vec3> GeometryParticle::findNextIndexedTriangle(Engine::Mesh& mesh) {
   glm::vec3 minDisplacement;
   float minDisplacementLength = std::numeric_limits<float>::max();
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "Engine.hpp"
+#include "Math.hpp"
+#include "Mesh.hpp"
 
 #include <glm/glm.hpp>
 #include <glm/mat4x4.hpp>
@@ -9,7 +10,6 @@
 
 class GeometryParticle {
   private:
-    Engine::Shader m_Shader;
     Engine::Mesh& m_Geometry;
 
     glm::vec3 m_Position;
@@ -27,9 +27,12 @@ class GeometryParticle {
     void update();
     glm::mat4 getTransform();
 
+    int getTriangleIndex() const { return m_TriangleIndex; }
+
   private:
     bool isInsideTriangle(glm::vec3 P0, glm::vec3 P1, glm::vec3 P2, glm::vec3 P);
     void moveToNextTriangle();
+    std::pair<int, glm::vec3> findAdjacentTriangle(const Engine::MeshTopology& topology);
     std::pair<int, glm::vec3> findNextTriangle(Engine::Mesh& mesh);
     std::pair<int, glm::vec3> findNextIndexedTriangle(Engine::Mesh& mesh);
     glm::vec3 rotate(glm::vec3 N0, glm::vec3 N1, glm::vec3 V);
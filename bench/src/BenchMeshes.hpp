@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Mesh.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace Bench {
+
+inline Engine::Mesh createGrid(size_t triangles, bool indexed, float tileSize = 0.02f) {
+    size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(triangles) / 2.0)));
+    size_t rows = (triangles / 2 + columns - 1) / columns;
+
+    std::vector<Engine::Vertex> vertices;
+    std::vector<unsigned int> indices;
+
+    // GeometryParticle::isInsideTriangle inverts a matrix built from the corners,
+    // so the grid must not pass through the origin.
+    auto position = [&](size_t i, size_t j) {
+        return glm::vec3(static_cast<float>(j) * tileSize, 1.0f, static_cast<float>(i) * tileSize);
+    };
+
+    auto vertex = [](glm::vec3 p) {
+        return Engine::Vertex(p, glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(0.0f), glm::vec3(0.0f), glm::vec3(0.0f),
+                              glm::vec3(0.0f));
+    };
+
+    if (indexed) {
+        for (size_t i = 0; i <= rows; i++) {
+            for (size_t j = 0; j <= columns; j++) {
+                vertices.push_back(vertex(position(i, j)));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < columns; j++) {
+            unsigned int v0 = static_cast<unsigned int>(i * (columns + 1) + j);
+            unsigned int v1 = static_cast<unsigned int>((i + 1) * (columns + 1) + j);
+            unsigned int v2 = v0 + 1;
+            unsigned int v3 = v1 + 1;
+
+            if (indexed) {
+                indices.insert(indices.end(), {v1, v2, v0, v1, v3, v2});
+            } else {
+                for (auto p : {position(i + 1, j), position(i, j + 1), position(i, j), position(i + 1, j),
+                               position(i + 1, j + 1), position(i, j + 1)}) {
+                    vertices.push_back(vertex(p));
+                }
+            }
+        }
+    }
+
+    return Engine::Mesh(vertices, indices);
+}
+
+inline Engine::Mesh createSphere(size_t triangles, float radius = 1.0f) {
+    size_t rings = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(triangles) / 4.0)));
+    size_t segments = rings * 2;
+    const float pi = 3.14159265f;
+
+    std::vector<Engine::Vertex> vertices;
+    std::vector<unsigned int> indices;
+
+    for (size_t i = 0; i <= rings; i++) {
+        float theta = pi * static_cast<float>(i) / static_cast<float>(rings);
+        for (size_t j = 0; j <= segments; j++) {
+            float phi = 2.0f * pi * static_cast<float>(j % segments) / static_cast<float>(segments);
+
+            // Poles and the seam must repeat exact positions to be welded.
+            float sinTheta = (i == 0 || i == rings) ? 0.0f : std::sin(theta);
+            float cosTheta = i == 0 ? 1.0f : (i == rings ? -1.0f : std::cos(theta));
+            glm::vec3 normal(sinTheta * std::cos(phi), cosTheta, sinTheta * std::sin(phi));
+
+            vertices.emplace_back(normal * radius, normal, glm::vec2(0.0f), glm::vec3(0.0f), glm::vec3(0.0f),
+                                  glm::vec3(0.0f));
+        }
+    }
+
+    for (size_t i = 0; i < rings; i++) {
+        for (size_t j = 0; j < segments; j++) {
+            unsigned int a = static_cast<unsigned int>(i * (segments + 1) + j);
+            unsigned int b = static_cast<unsigned int>(a + segments + 1);
+
+            if (i != 0) {
+                indices.insert(indices.end(), {a, a + 1, b});
+            }
+            if (i != rings - 1) {
+                indices.insert(indices.end(), {a + 1, b + 1, b});
+            }
+        }
+    }
+
+    return Engine::Mesh(vertices, indices);
+}
+
+} // namespace Bench
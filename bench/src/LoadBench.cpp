@@ -0,0 +1,173 @@
+#include "JobPool.hpp"
+#include "ModelLoader.hpp"
+#include "ObjParser.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Compares OBJ load throughput of the memory-mapped ObjParser, on one thread
+// and on a JobPool, against the original std::ifstream reader. The input is a
+// generated v/t/n triangle grid, the only form the original reader handles;
+// pass a path to time an existing file with ObjParser alone.
+//
+// Then times ModelLoader::loadObj importing the grid (parse, index, build
+// topology and frames, write the .mesh cache) against loading it back from
+// the cache.
+
+namespace {
+
+constexpr int c_Runs = 3;
+
+void writeGrid(const std::string &path, size_t columns) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    float step = 1.0f / static_cast<float>(columns);
+
+    for (size_t z = 0; z <= columns; z++) {
+        for (size_t x = 0; x <= columns; x++) {
+            float u = static_cast<float>(x) * step;
+            float v = static_cast<float>(z) * step;
+            out << "v " << u << " " << 0.1f * u * v << " " << v << "\n";
+            out << "vt " << u << " " << v << "\n";
+        }
+    }
+    out << "vn 0 1 0\n";
+
+    auto corner = [&](size_t x, size_t z) {
+        size_t index = z * (columns + 1) + x + 1;
+        out << " " << index << "/" << index << "/1";
+    };
+    for (size_t z = 0; z < columns; z++) {
+        for (size_t x = 0; x < columns; x++) {
+            out << "f";
+            corner(x, z), corner(x, z + 1), corner(x + 1, z + 1);
+            out << "\nf";
+            corner(x, z), corner(x + 1, z + 1), corner(x + 1, z);
+            out << "\n";
+        }
+    }
+}
+
+// The reader ModelLoader::loadObj used before ObjParser
+size_t loadStream(const std::string &path) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    std::string line;
+
+    std::string attribute;
+    std::vector<glm::vec3> pVertices;
+    std::vector<glm::vec3> nVertices;
+    std::vector<glm::vec2> tVertices;
+    std::vector<Engine::Vertex> vertices;
+
+    while (!in.eof() && in >> attribute) {
+        if (attribute == "v") {
+            float x, y, z;
+            in >> x >> y >> z;
+            pVertices.emplace_back(x, y, z);
+        } else if (attribute == "vt") {
+            float x, y;
+            in >> x >> y;
+            tVertices.emplace_back(x, y);
+        } else if (attribute == "vn") {
+            float x, y, z;
+            in >> x >> y >> z;
+            nVertices.emplace_back(x, y, z);
+        } else if (attribute == "f") {
+            char divider;
+            size_t p, t, n;
+            for (int i = 0; i < 3; i++) {
+                in >> p >> divider >> t >> divider >> n;
+                vertices.emplace_back(pVertices[p - 1], nVertices[n - 1], tVertices[t - 1],
+                                      glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f));
+            }
+        } else {
+            std::getline(in, line);
+        }
+    }
+
+    return vertices.size();
+}
+
+template <typename Load> double best(Load load) {
+    double fastest = 0.0;
+    for (int run = 0; run < c_Runs; run++) {
+        auto start = std::chrono::steady_clock::now();
+        load();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fastest = run == 0 || seconds < fastest ? seconds : fastest;
+    }
+    return fastest;
+}
+
+double megabytesPerSecond(size_t bytes, double seconds) { return static_cast<double>(bytes) / seconds / 1e6; }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Engine::JobPool jobs;
+
+    if (argc > 1) {
+        Engine::ObjParser parser;
+        double seconds = best([&]() { parser.parse(argv[1], jobs); });
+        const Engine::ObjParser::Stats &stats = parser.getStats();
+
+        std::printf("%s: %zu bytes, %zu chunks, %zu triangles, %zu skipped faces, %zu skipped triangles\n", argv[1],
+                    stats.bytes, stats.chunks, stats.triangles, stats.skippedFaces, stats.skippedTriangles);
+        std::printf("%.1f ms, %.0f MB/s on %u threads\n", seconds * 1e3, megabytesPerSecond(stats.bytes, seconds),
+                    jobs.getThreadCount() + 1);
+        return 0;
+    }
+
+    std::printf("%-10s %8s %12s %12s %12s %12s %10s\n", "triangles", "MB", "stream MB/s", "mmap MB/s", "pool MB/s",
+                "pool ms", "speedup");
+
+    std::string path = "load_bench.obj";
+    for (size_t columns : {100ul, 300ul, 1'000ul}) {
+        writeGrid(path, columns);
+
+        Engine::ObjParser parser;
+        parser.setChunkBytes(1 << 20);
+
+        size_t streamVertices = 0;
+        double streamSeconds = best([&]() { streamVertices = loadStream(path); });
+        double mappedSeconds = best([&]() { parser.parse(path); });
+        double poolSeconds = best([&]() { parser.parse(path, jobs); });
+
+        const Engine::ObjParser::Stats &stats = parser.getStats();
+        if (streamVertices != parser.getVertices().size()) {
+            std::fprintf(stderr, "vertex count mismatch: %zu stream, %zu mmap\n", streamVertices,
+                         parser.getVertices().size());
+        }
+
+        std::printf("%-10zu %8.1f %12.0f %12.0f %12.0f %12.1f %9.1fx\n", stats.triangles,
+                    static_cast<double>(stats.bytes) / 1e6, megabytesPerSecond(stats.bytes, streamSeconds),
+                    megabytesPerSecond(stats.bytes, mappedSeconds), megabytesPerSecond(stats.bytes, poolSeconds),
+                    poolSeconds * 1e3, streamSeconds / poolSeconds);
+    }
+
+    std::printf("\n%-10s %12s %12s %10s\n", "triangles", "import ms", "cached ms", "speedup");
+    for (size_t columns : {100ul, 300ul, 1'000ul}) {
+        writeGrid(path, columns);
+        std::string cachePath = path + ".mesh";
+        std::remove(cachePath.c_str());
+
+        std::shared_ptr<Engine::Model> model;
+        auto start = std::chrono::steady_clock::now();
+        model = Engine::ModelLoader::loadObj(path, jobs);
+        double importSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double cachedSeconds = best([&]() { model = Engine::ModelLoader::loadObj(path, jobs); });
+
+        std::printf("%-10zu %12.1f %12.1f %9.1fx\n", model->meshes.front().topology.triangleCount(),
+                    importSeconds * 1e3, cachedSeconds * 1e3, importSeconds / cachedSeconds);
+        std::remove(cachePath.c_str());
+    }
+    std::remove(path.c_str());
+
+    return 0;
+}
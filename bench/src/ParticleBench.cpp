@@ -0,0 +1,319 @@
+#include "BarycentricParticleSystem.hpp"
+#include "GeometryParticle.hpp"
+#include "JobPool.hpp"
+#include "Math.hpp"
+#include "ModelFactory.hpp"
+#include "ModelLoader.hpp"
+#include "SurfaceParticleSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Headless surface walker benchmark. Links only EngineCore, so it runs without
+// a display or GPU, and prints a single JSON object to stdout.
+//
+//   particle_bench [--mesh plane|sphere|<file.obj>] [--size N] [--particles N] [--steps N]
+//                  [--dt seconds] [--speed units/s] [--threads N] [--simd scalar|sse4|avx2]
+//                  [--walker system|barycentric|legacy] [--seed N] [--separation radius]
+//                  [--deform vertices] [--snapshot path]
+//
+// --size is the plane resolution in tiles per side or the sphere subdivision level.
+// --separation turns on neighbour avoidance for the system walker.
+// --deform moves a window of that many vertices every step and commits the
+// edit, so the surface caches and particles have to follow it.
+// --snapshot saves the system walkers to path after the run and restores them
+// into a fresh system, timing both.
+
+namespace {
+
+struct Options {
+    std::string mesh = "plane";
+    int size = 256;
+    size_t particles = 100'000;
+    size_t steps = 240;
+    float dt = 1.0f / 60.0f;
+    float speed = 0.3f;
+    int threads = -1;
+    std::string simd;
+    std::string walker = "system";
+    unsigned long long seed = 42;
+    float separation = 0.0f;
+    size_t deform = 0;
+    std::string snapshot;
+};
+
+struct Result {
+    double seconds = 0.0;
+    size_t crossings = 0;
+    size_t bounces = 0;
+    float bytesPerParticle = 0.0f;
+    unsigned threads = 1;
+    const char *simd = "none";
+    double deformSeconds = 0.0;
+    double snapshotSaveSeconds = 0.0;
+    double snapshotLoadSeconds = 0.0;
+};
+
+void usage() {
+    std::fprintf(stderr, "usage: particle_bench [--mesh plane|sphere|<file.obj>] [--size N] [--particles N] "
+                         "[--steps N] [--dt s] [--speed u/s] [--threads N] [--simd scalar|sse4|avx2] "
+                         "[--walker system|barycentric|legacy] [--seed N] [--separation radius] "
+                         "[--deform vertices] [--snapshot path]\n");
+}
+
+bool parse(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            return false;
+        }
+
+        const char *key = argv[i];
+        const char *value = argv[++i];
+
+        if (std::strcmp(key, "--mesh") == 0) {
+            options.mesh = value;
+        } else if (std::strcmp(key, "--size") == 0) {
+            options.size = std::atoi(value);
+        } else if (std::strcmp(key, "--particles") == 0) {
+            options.particles = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(key, "--steps") == 0) {
+            options.steps = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(key, "--dt") == 0) {
+            options.dt = std::strtof(value, nullptr);
+        } else if (std::strcmp(key, "--speed") == 0) {
+            options.speed = std::strtof(value, nullptr);
+        } else if (std::strcmp(key, "--threads") == 0) {
+            options.threads = std::atoi(value);
+        } else if (std::strcmp(key, "--simd") == 0) {
+            options.simd = value;
+        } else if (std::strcmp(key, "--walker") == 0) {
+            options.walker = value;
+        } else if (std::strcmp(key, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(key, "--separation") == 0) {
+            options.separation = std::strtof(value, nullptr);
+        } else if (std::strcmp(key, "--deform") == 0) {
+            options.deform = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(key, "--snapshot") == 0) {
+            options.snapshot = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<Engine::Model> loadMesh(const Options &options) {
+    if (options.mesh == "plane") {
+        // Lifted off the origin: GeometryParticle cannot walk planes through it.
+        auto model = Engine::ModelFactory::createPlane(4.0f / static_cast<float>(options.size), options.size,
+                                                       options.size);
+        for (auto &vertex : model->meshes[0].vertices) {
+            vertex.position.y = 1.0f;
+        }
+        return model;
+    }
+
+    if (options.mesh == "sphere") {
+        return Engine::ModelFactory::createSphere(2.0f, options.size);
+    }
+
+    return Engine::ModelLoader::loadObj(options.mesh);
+}
+
+double elapsedSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Pushes a window of vertices sliding through the vertex array along their normals and commits it.
+// Returns the seconds spent in the commit.
+double deform(Engine::Mesh &mesh, size_t step, size_t count) {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    count = std::min(count, mesh.vertices.size());
+    size_t first = (step * count) % (mesh.vertices.size() - count + 1);
+    float offset = 0.002f * std::sin(static_cast<float>(step) * 0.1f);
+    for (size_t i = first; i < first + count; i++) {
+        mesh.vertices[i].position += mesh.vertices[i].normal * offset;
+    }
+    mesh.markVerticesDirty(first, count);
+
+    auto start = std::chrono::steady_clock::now();
+    mesh.commitChanges();
+    return elapsedSince(start);
+}
+
+unsigned threadCount(const Options &options) {
+    return options.threads >= 1 ? static_cast<unsigned>(options.threads - 1) : Engine::JobPool::defaultThreadCount();
+}
+
+Result runSystem(Engine::Mesh &mesh, const Options &options) {
+    Result result;
+
+    Engine::SurfaceParticleSystem system(mesh);
+    system.setSpeed(options.speed);
+    system.setSeparation(options.separation);
+
+    if (!options.simd.empty()) {
+        for (auto level : {Engine::SimdLevel::Scalar, Engine::SimdLevel::SSE4, Engine::SimdLevel::AVX2}) {
+            if (options.simd == Engine::SurfaceKernels::name(level) && Engine::SurfaceKernels::isSupported(level)) {
+                system.setSimdLevel(level);
+            }
+        }
+    }
+
+    Engine::JobPool jobs(threadCount(options));
+
+    system.spawn(options.particles, jobs);
+    jobs.wait();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t step = 0; step < options.steps; step++) {
+        result.deformSeconds += deform(mesh, step, options.deform);
+        system.update(options.dt, jobs);
+        jobs.wait();
+    }
+    result.seconds = elapsedSince(start);
+
+    result.crossings = system.getStats().crossings;
+    result.bounces = system.getStats().bounces;
+    result.bytesPerParticle = system.bytesPerParticle();
+    result.threads = jobs.getThreadCount() + 1;
+    result.simd = Engine::SurfaceKernels::name(system.getSimdLevel());
+
+    if (!options.snapshot.empty()) {
+        start = std::chrono::steady_clock::now();
+        bool saved = system.saveSnapshot(options.snapshot);
+        result.snapshotSaveSeconds = elapsedSince(start);
+
+        Engine::SurfaceParticleSystem restored(mesh);
+        start = std::chrono::steady_clock::now();
+        bool loaded = saved && restored.loadSnapshot(options.snapshot, jobs);
+        result.snapshotLoadSeconds = elapsedSince(start);
+
+        if (!loaded || restored.size() != system.size()) {
+            std::fprintf(stderr, "particle_bench: snapshot round trip through '%s' failed\n", options.snapshot.c_str());
+        }
+    }
+    return result;
+}
+
+Result runBarycentric(Engine::Mesh &mesh, const Options &options) {
+    Result result;
+
+    Engine::BarycentricParticleSystem system(mesh);
+    system.setSpeed(options.speed);
+
+    Engine::JobPool jobs(threadCount(options));
+
+    system.spawn(options.particles, jobs);
+    jobs.wait();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t step = 0; step < options.steps; step++) {
+        result.deformSeconds += deform(mesh, step, options.deform);
+        system.update(options.dt, jobs);
+        jobs.wait();
+    }
+    result.seconds = elapsedSince(start);
+
+    result.crossings = system.getStats().crossings;
+    result.bounces = system.getStats().bounces;
+    result.bytesPerParticle = system.bytesPerParticle();
+    result.threads = jobs.getThreadCount() + 1;
+    return result;
+}
+
+Result runLegacy(Engine::Mesh &mesh, const Options &options) {
+    Result result;
+
+    std::vector<GeometryParticle> particles;
+    particles.reserve(options.particles);
+    for (size_t i = 0; i < options.particles; i++) {
+        particles.emplace_back(mesh);
+        particles.back().setUp();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t step = 0; step < options.steps; step++) {
+        for (auto &particle : particles) {
+            int triangle = particle.getTriangleIndex();
+            particle.update();
+            result.crossings += particle.getTriangleIndex() != triangle;
+        }
+    }
+    result.seconds = elapsedSince(start);
+
+    result.bytesPerParticle = static_cast<float>(sizeof(GeometryParticle));
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+
+    Engine::Math::srand(options.seed);
+
+    auto model = loadMesh(options);
+    if (!model || model->meshes.empty() || model->meshes[0].vertices.empty()) {
+        std::fprintf(stderr, "particle_bench: could not load mesh '%s'\n", options.mesh.c_str());
+        return 1;
+    }
+
+    Engine::Mesh &mesh = model->meshes[0];
+    mesh.buildTopology();
+
+    Result result;
+    if (options.walker == "legacy") {
+        result = runLegacy(mesh, options);
+    } else if (options.walker == "barycentric") {
+        result = runBarycentric(mesh, options);
+    } else if (options.walker == "system") {
+        result = runSystem(mesh, options);
+    } else {
+        usage();
+        return 1;
+    }
+
+    double stepCount = static_cast<double>(options.particles) * static_cast<double>(options.steps);
+    double seconds = result.seconds > 0.0 ? result.seconds : 1e-9;
+
+    std::printf("{\n");
+    std::printf("  \"walker\": \"%s\",\n", options.walker.c_str());
+    std::printf("  \"mesh\": \"%s\",\n", options.mesh.c_str());
+    std::printf("  \"triangles\": %zu,\n", mesh.topology.triangleCount());
+    std::printf("  \"particles\": %zu,\n", options.particles);
+    std::printf("  \"steps\": %zu,\n", options.steps);
+    std::printf("  \"dt\": %g,\n", static_cast<double>(options.dt));
+    std::printf("  \"threads\": %u,\n", result.threads);
+    std::printf("  \"simd\": \"%s\",\n", result.simd);
+    std::printf("  \"seed\": %llu,\n", options.seed);
+    std::printf("  \"separation\": %g,\n", static_cast<double>(options.separation));
+    std::printf("  \"deform\": %zu,\n", options.deform);
+    std::printf("  \"deform_seconds\": %.6f,\n", result.deformSeconds);
+    std::printf("  \"snapshot_save_seconds\": %.6f,\n", result.snapshotSaveSeconds);
+    std::printf("  \"snapshot_load_seconds\": %.6f,\n", result.snapshotLoadSeconds);
+    std::printf("  \"seconds\": %.6f,\n", result.seconds);
+    std::printf("  \"steps_per_second\": %.6e,\n", stepCount / seconds);
+    std::printf("  \"crossings\": %zu,\n", result.crossings);
+    std::printf("  \"crossings_per_second\": %.6e,\n", static_cast<double>(result.crossings) / seconds);
+    std::printf("  \"bounces\": %zu,\n", result.bounces);
+    std::printf("  \"bytes_per_particle\": %.2f\n", static_cast<double>(result.bytesPerParticle));
+    std::printf("}\n");
+
+    return 0;
+}
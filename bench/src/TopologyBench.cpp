@@ -0,0 +1,75 @@
+#include "BenchMeshes.hpp"
+#include "GeometryParticle.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Compares edge crossings per second of GeometryParticle when the host mesh
+// has a precomputed MeshTopology (O(1) neighbour lookup) against the
+// original scan over every triangle of the mesh.
+
+namespace {
+
+constexpr size_t c_Particles = 256;
+constexpr size_t c_MaxFrames = 4000;
+constexpr double c_TimeBudget = 1.0;
+
+double run(Engine::Mesh &mesh, size_t &crossings) {
+    Engine::Math::srand(42);
+
+    std::vector<GeometryParticle> particles;
+    particles.reserve(c_Particles);
+    for (size_t i = 0; i < c_Particles; i++) {
+        particles.emplace_back(mesh);
+        particles.back().setUp();
+    }
+
+    crossings = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+
+    for (size_t frame = 0; frame < c_MaxFrames && elapsed < c_TimeBudget; frame++) {
+        for (auto &particle : particles) {
+            int triangle = particle.getTriangleIndex();
+            particle.update();
+            crossings += particle.getTriangleIndex() != triangle;
+        }
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return elapsed;
+}
+
+} // namespace
+
+int main() {
+    std::printf("%-10s %-8s %12s %16s %16s %10s\n", "triangles", "layout", "build ms", "scan cross/s",
+                "topology cross/s", "speedup");
+
+    for (size_t triangles : {1'000ul, 10'000ul, 100'000ul, 1'000'000ul}) {
+        for (bool indexed : {true, false}) {
+            Engine::Mesh scanMesh = Bench::createGrid(triangles, indexed);
+            Engine::Mesh topologyMesh = scanMesh;
+
+            auto buildStart = std::chrono::steady_clock::now();
+            topologyMesh.buildTopology();
+            double buildMs =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+
+            size_t scanCrossings, topologyCrossings;
+            double scanSeconds = run(scanMesh, scanCrossings);
+            double topologySeconds = run(topologyMesh, topologyCrossings);
+
+            double scanRate = static_cast<double>(scanCrossings) / scanSeconds;
+            double topologyRate = static_cast<double>(topologyCrossings) / topologySeconds;
+
+            std::printf("%-10zu %-8s %12.2f %16.0f %16.0f %9.1fx\n", topologyMesh.topology.triangleCount(),
+                        indexed ? "indexed" : "soup", buildMs, scanRate, topologyRate, topologyRate / scanRate);
+        }
+    }
+
+    return 0;
+}
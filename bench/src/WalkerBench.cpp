@@ -0,0 +1,239 @@
+#include "BenchMeshes.hpp"
+#include "GeometryParticle.hpp"
+#include "JobPool.hpp"
+#include "SurfaceParticleSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Compares surface walker steps per second of the per-particle
+// GeometryParticle::update loop with the SurfaceParticleSystem batch kernels,
+// then measures how the chunked update scales with JobPool threads, what
+// building instance transforms costs per particle and how fast spawning is.
+
+namespace {
+
+constexpr size_t c_Particles = 100'000;
+constexpr size_t c_Frames = 120;
+constexpr float c_DeltaSeconds = 1.0f / 60.0f;
+
+double elapsedSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double runGeometryParticles(Engine::Mesh &mesh) {
+    Engine::Math::srand(42);
+
+    std::vector<GeometryParticle> particles;
+    particles.reserve(c_Particles);
+    for (size_t i = 0; i < c_Particles; i++) {
+        particles.emplace_back(mesh);
+        particles.back().setUp();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < c_Frames; frame++) {
+        for (auto &particle : particles) {
+            particle.update();
+        }
+    }
+
+    return static_cast<double>(c_Particles * c_Frames) / elapsedSince(start);
+}
+
+double runSystem(Engine::Mesh &mesh, Engine::SimdLevel level) {
+    Engine::Math::srand(42);
+
+    Engine::SurfaceParticleSystem system(mesh);
+    system.setSimdLevel(level);
+    system.spawn(c_Particles);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < c_Frames; frame++) {
+        system.update(c_DeltaSeconds);
+    }
+
+    return static_cast<double>(c_Particles * c_Frames) / elapsedSince(start);
+}
+
+double runSystem(Engine::Mesh &mesh, Engine::JobPool &jobs) {
+    Engine::Math::srand(42);
+
+    Engine::SurfaceParticleSystem system(mesh);
+    system.spawn(c_Particles);
+    jobs.resetStats();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < c_Frames; frame++) {
+        system.update(c_DeltaSeconds, jobs);
+        jobs.wait();
+    }
+
+    return static_cast<double>(c_Particles * c_Frames) / elapsedSince(start);
+}
+
+void reportScaling(const char *name, Engine::Mesh mesh) {
+    mesh.buildTopology();
+
+    unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+    Engine::JobPool jobs(0);
+
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < cores; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(cores);
+
+    double single = 0.0;
+    for (unsigned threads : counts) {
+        // The thread calling wait() works too, so it counts as one of them.
+        jobs.setThreadCount(threads - 1);
+
+        double rate = runSystem(mesh, jobs);
+        if (threads == 1) {
+            single = rate;
+        }
+
+        double busiest = 0.0, total = 0.0;
+        for (const auto &stats : jobs.getStats()) {
+            busiest = std::max(busiest, stats.busySeconds);
+            total += stats.busySeconds;
+        }
+
+        std::printf("%-8s %-16u %14.3e %7.1fx %9.2f\n", name, threads, rate, rate / single,
+                    busiest > 0.0 ? total / (busiest * threads) : 0.0);
+    }
+}
+
+double runGeometryTransforms(Engine::Mesh &mesh) {
+    Engine::Math::srand(42);
+
+    std::vector<GeometryParticle> particles;
+    particles.reserve(c_Particles);
+    for (size_t i = 0; i < c_Particles; i++) {
+        particles.emplace_back(mesh);
+        particles.back().setUp();
+    }
+
+    // Mirrors the old per-particle draw loop: basis from two quaternions,
+    // then the geometry and particle scale matrices multiplied in.
+    glm::mat4 geometryTransform(1.0f), particleTransform(1.0f);
+    std::vector<glm::mat4> transforms(c_Particles);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < c_Frames; frame++) {
+        for (size_t i = 0; i < c_Particles; i++) {
+            transforms[i] = geometryTransform * particles[i].getTransform() * particleTransform;
+        }
+    }
+
+    return elapsedSince(start) * 1e9 / static_cast<double>(c_Particles * c_Frames);
+}
+
+double runSystemTransforms(Engine::Mesh &mesh, Engine::SimdLevel level) {
+    Engine::Math::srand(42);
+
+    Engine::SurfaceParticleSystem system(mesh);
+    system.setSimdLevel(level);
+    system.spawn(c_Particles);
+
+    std::vector<float> rows(c_Particles * Engine::SurfaceKernels::c_TransformFloats);
+
+    double nanoseconds = 0.0;
+    for (size_t frame = 0; frame < c_Frames; frame++) {
+        system.writeTransforms(rows.data());
+        nanoseconds += system.getTransformNanoseconds();
+    }
+
+    return nanoseconds / static_cast<double>(c_Frames);
+}
+
+void reportTransforms(const char *name, Engine::Mesh mesh) {
+    mesh.buildTopology();
+
+    double reference = runGeometryTransforms(mesh);
+    std::printf("%-8s %-16s %14.2f %8s\n", name, "GeometryParticle", reference, "1.0x");
+
+    for (auto level : {Engine::SimdLevel::Scalar, Engine::SimdLevel::AVX2}) {
+        if (!Engine::SurfaceKernels::isSupported(level)) {
+            continue;
+        }
+
+        double nanoseconds = runSystemTransforms(mesh, level);
+        std::printf("%-8s %-16s %14.2f %7.1fx\n", name, Engine::SurfaceKernels::name(level), nanoseconds,
+                    reference / nanoseconds);
+    }
+}
+
+void reportSpawn(const char *name, Engine::Mesh mesh) {
+    constexpr size_t c_SpawnParticles = 10'000'000;
+
+    mesh.buildTopology();
+    Engine::SurfaceParticleSystem system(mesh);
+    Engine::JobPool jobs;
+
+    // The first spawn pays for page faults; time a second one into the reserved arrays.
+    for (unsigned threads : {1u, jobs.getThreadCount() + 1}) {
+        system.spawn(c_SpawnParticles);
+        system.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        if (threads == 1) {
+            system.spawn(c_SpawnParticles);
+        } else {
+            system.spawn(c_SpawnParticles, jobs);
+            jobs.wait();
+        }
+        double seconds = elapsedSince(start);
+        system.clear();
+
+        std::printf("%-8s %-16u %14.3f %14.1f\n", name, threads, seconds,
+                    seconds * 1e9 / static_cast<double>(c_SpawnParticles));
+    }
+}
+
+void report(const char *name, Engine::Mesh mesh) {
+    mesh.buildTopology();
+
+    double reference = runGeometryParticles(mesh);
+    std::printf("%-8s %-16s %14.3e %8s\n", name, "GeometryParticle", reference, "1.0x");
+
+    for (auto level : {Engine::SimdLevel::Scalar, Engine::SimdLevel::SSE4, Engine::SimdLevel::AVX2}) {
+        if (!Engine::SurfaceKernels::isSupported(level)) {
+            continue;
+        }
+
+        double rate = runSystem(mesh, level);
+        std::printf("%-8s %-16s %14.3e %7.1fx\n", name, Engine::SurfaceKernels::name(level), rate, rate / reference);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::printf("%-8s %-16s %14s %8s\n", "mesh", "kernel", "steps/s", "speedup");
+
+    report("grid", Bench::createGrid(20'000, true, 0.1f));
+    report("sphere", Bench::createSphere(20'000, 2.0f));
+
+    std::printf("\n%-8s %-16s %14s %8s %9s\n", "mesh", "threads", "steps/s", "speedup", "balance");
+
+    reportScaling("grid", Bench::createGrid(20'000, true, 0.1f));
+    reportScaling("sphere", Bench::createSphere(20'000, 2.0f));
+
+    std::printf("\n%-8s %-16s %14s %8s\n", "mesh", "transforms", "ns/particle", "speedup");
+
+    reportTransforms("grid", Bench::createGrid(20'000, true, 0.1f));
+    reportTransforms("sphere", Bench::createSphere(20'000, 2.0f));
+
+    std::printf("\n%-8s %-16s %14s %14s\n", "mesh", "spawn threads", "s/10M", "ns/particle");
+
+    reportSpawn("grid", Bench::createGrid(20'000, true, 0.1f));
+    reportSpawn("sphere", Bench::createSphere(20'000, 2.0f));
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "AtomicFileWriter.hpp"
+
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ENGINE_HAS_FSYNC 1
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <atomic>
+#include <chrono>
+#endif
+
+namespace Engine {
+
+namespace {
+
+#ifdef ENGINE_HAS_FSYNC
+// fsync on the directory makes the rename itself durable.
+bool syncDirectoryOf(const std::string &path) {
+    size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+
+    int descriptor = ::open(directory.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    bool synced = ::fsync(descriptor) == 0;
+    ::close(descriptor);
+    return synced;
+}
+#endif
+
+} // namespace
+
+bool AtomicFileWriter::open(const std::string &path) {
+    discard();
+    m_Path = path;
+    m_Failed = false;
+
+#ifdef ENGINE_HAS_FSYNC
+    m_Temporary = path + ".XXXXXX";
+    std::vector<char> name(m_Temporary.begin(), m_Temporary.end());
+    name.push_back('\0');
+
+    int descriptor = ::mkstemp(name.data());
+    if (descriptor < 0) {
+        return false;
+    }
+    m_Temporary = name.data();
+
+    // mkstemp creates the file private to the user; give it the usual mode.
+    ::fchmod(descriptor, 0644);
+    m_File = ::fdopen(descriptor, "wb");
+    if (m_File == nullptr) {
+        ::close(descriptor);
+        std::remove(m_Temporary.c_str());
+    }
+#else
+    static std::atomic<unsigned> counter{0};
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    m_Temporary = path + "." + std::to_string(stamp) + "." + std::to_string(counter.fetch_add(1)) + ".tmp";
+    m_File = std::fopen(m_Temporary.c_str(), "wb");
+#endif
+
+    return m_File != nullptr;
+}
+
+void AtomicFileWriter::write(const void *data, size_t bytes) {
+    if (m_File == nullptr || m_Failed || bytes == 0) {
+        return;
+    }
+    m_Failed = std::fwrite(data, 1, bytes, m_File) != bytes;
+}
+
+void AtomicFileWriter::writeZeros(size_t bytes) {
+    static const char zeros[256] = {};
+    while (bytes > 0) {
+        size_t chunk = bytes < sizeof(zeros) ? bytes : sizeof(zeros);
+        write(zeros, chunk);
+        bytes -= chunk;
+    }
+}
+
+bool AtomicFileWriter::commit() {
+    if (m_File == nullptr) {
+        return false;
+    }
+
+    bool written = !m_Failed && std::fflush(m_File) == 0;
+#ifdef ENGINE_HAS_FSYNC
+    written = written && ::fsync(::fileno(m_File)) == 0;
+#endif
+    written = std::fclose(m_File) == 0 && written;
+    m_File = nullptr;
+
+    if (!written || std::rename(m_Temporary.c_str(), m_Path.c_str()) != 0) {
+        std::remove(m_Temporary.c_str());
+        m_Temporary.clear();
+        return false;
+    }
+    m_Temporary.clear();
+
+#ifdef ENGINE_HAS_FSYNC
+    syncDirectoryOf(m_Path);
+#endif
+    return true;
+}
+
+void AtomicFileWriter::discard() {
+    if (m_File != nullptr) {
+        std::fclose(m_File);
+        m_File = nullptr;
+    }
+    if (!m_Temporary.empty()) {
+        std::remove(m_Temporary.c_str());
+        m_Temporary.clear();
+    }
+}
+
+} // namespace Engine
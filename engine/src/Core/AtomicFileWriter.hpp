@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+namespace Engine {
+
+/**
+ * Writes a file under a unique temporary name next to its path and renames
+ * it over the path on commit(), so readers see the old file or the whole new
+ * one and concurrent writers never share a temporary. Where POSIX is
+ * available the data is synced before the rename and the directory after
+ * it, so a committed file also survives a crash whole.
+ *
+ * Anything not committed is removed on discard() or destruction.
+ */
+class AtomicFileWriter {
+  private:
+    std::string m_Path;
+    std::string m_Temporary;
+    std::FILE *m_File = nullptr;
+    bool m_Failed = false;
+
+  public:
+    AtomicFileWriter() = default;
+    ~AtomicFileWriter() { discard(); }
+
+    AtomicFileWriter(const AtomicFileWriter &) = delete;
+    AtomicFileWriter &operator=(const AtomicFileWriter &) = delete;
+
+    bool open(const std::string &path);
+
+    // Failures are remembered and reported by commit().
+    void write(const void *data, size_t bytes);
+    void writeZeros(size_t bytes);
+
+    bool commit();
+    void discard();
+
+    bool isOpen() const { return m_File != nullptr; }
+};
+
+} // namespace Engine
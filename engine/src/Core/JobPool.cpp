@@ -0,0 +1,207 @@
+#include "JobPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+namespace Engine {
+
+JobPool::JobPool(unsigned threads) { start(threads); }
+
+JobPool::~JobPool() {
+    wait();
+    stop();
+}
+
+unsigned JobPool::defaultThreadCount() {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+void JobPool::start(unsigned threads) {
+    m_Workers.clear();
+    for (unsigned i = 0; i <= threads; i++) {
+        m_Workers.push_back(std::make_unique<Worker>());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Running = true;
+    }
+
+    for (unsigned i = 0; i < threads; i++) {
+        m_Threads.emplace_back(&JobPool::workerLoop, this, i);
+    }
+}
+
+void JobPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Running = false;
+    }
+    m_WakeUp.notify_all();
+
+    for (auto &thread : m_Threads) {
+        thread.join();
+    }
+    m_Threads.clear();
+}
+
+void JobPool::setThreadCount(unsigned threads) {
+    if (threads == getThreadCount()) {
+        return;
+    }
+
+    wait();
+    stop();
+    start(threads);
+}
+
+void JobPool::submit(Job job) {
+    unsigned threads = getThreadCount();
+    unsigned worker = threads > 0 ? m_NextWorker.fetch_add(1, std::memory_order_relaxed) % threads : threads;
+
+    m_Pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(m_Workers[worker]->mutex);
+        m_Workers[worker]->jobs.push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Queued.fetch_add(1);
+    }
+    m_WakeUp.notify_one();
+}
+
+void JobPool::submit(Job job, Batch &batch) {
+    batch.m_Pending.fetch_add(1);
+    submit([this, job = std::move(job), &batch](unsigned worker) {
+        job(worker);
+        if (batch.m_Pending.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(m_SleepMutex);
+            m_Done.notify_all();
+        }
+    });
+}
+
+void JobPool::parallelFor(size_t count, size_t chunkSize, const RangeJob &job) {
+    chunkSize = std::max<size_t>(chunkSize, 1);
+
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        size_t end = std::min(begin + chunkSize, count);
+        submit([job, begin, end](unsigned worker) { job(begin, end, worker); });
+    }
+}
+
+void JobPool::parallelFor(size_t count, size_t chunkSize, const RangeJob &job, Batch &batch) {
+    chunkSize = std::max<size_t>(chunkSize, 1);
+
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        size_t end = std::min(begin + chunkSize, count);
+        submit([job, begin, end](unsigned worker) { job(begin, end, worker); }, batch);
+    }
+}
+
+void JobPool::wait() { waitUntil(m_Pending); }
+
+void JobPool::wait(const Batch &batch) { waitUntil(batch.m_Pending); }
+
+void JobPool::waitUntil(const std::atomic<size_t> &pending) {
+    unsigned worker = getThreadCount();
+
+    // Jobs of other batches may run here too; they are taken in queue order like any other.
+    while (pending.load() > 0) {
+        if (tryRun(worker)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_Done.wait_for(lock, std::chrono::milliseconds(1),
+                        [this, &pending]() { return pending.load() == 0 || m_Queued.load() > 0; });
+    }
+}
+
+void JobPool::workerLoop(unsigned worker) {
+    while (true) {
+        if (tryRun(worker)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_WakeUp.wait(lock, [this]() { return !m_Running || m_Queued.load() > 0; });
+
+        if (!m_Running && m_Queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+bool JobPool::tryRun(unsigned worker) {
+    Job job;
+    if (!takeJob(worker, job)) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    job(worker);
+    auto &stats = m_Workers[worker]->stats;
+    stats.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.jobs++;
+
+    if (m_Pending.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Done.notify_all();
+    }
+
+    return true;
+}
+
+bool JobPool::takeJob(unsigned worker, Job &job) {
+    if (m_Queued.load() == 0) {
+        return false;
+    }
+
+    {
+        auto &own = *m_Workers[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            m_Queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    unsigned slots = getSlotCount();
+    for (unsigned i = 1; i < slots; i++) {
+        auto &victim = *m_Workers[(worker + i) % slots];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            m_Queued.fetch_sub(1);
+            m_Workers[worker]->stats.steals++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<JobPool::WorkerStats> JobPool::getStats() const {
+    std::vector<WorkerStats> stats;
+    stats.reserve(m_Workers.size());
+    for (const auto &worker : m_Workers) {
+        stats.push_back(worker->stats);
+    }
+    return stats;
+}
+
+void JobPool::resetStats() {
+    for (auto &worker : m_Workers) {
+        worker->stats = WorkerStats();
+    }
+}
+
+} // namespace Engine
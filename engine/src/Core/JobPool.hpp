@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Work-stealing thread pool. Every worker owns a job queue: it takes its own
+ * jobs from the back and steals from the front of other queues when idle.
+ * The thread calling wait() joins in as one more worker until every
+ * submitted job is done.
+ *
+ * Jobs receive the index of the worker slot running them; the slot of the
+ * waiting thread is getThreadCount().
+ *
+ * Jobs submitted with a Batch can be waited on alone: wait(batch) returns
+ * once that batch is done, even while other jobs are still queued. There is
+ * one waiter slot, so only one thread may wait at a time, and jobs must not
+ * wait on the pool that runs them.
+ */
+class JobPool {
+  public:
+    using Job = std::function<void(unsigned worker)>;
+    using RangeJob = std::function<void(size_t begin, size_t end, unsigned worker)>;
+
+    struct WorkerStats {
+        double busySeconds = 0.0;
+        size_t jobs = 0;
+        size_t steals = 0;
+    };
+
+  private:
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        WorkerStats stats;
+    };
+
+  public:
+    // Counts the unfinished jobs of one batch. It must outlive them, so wait on it before it goes.
+    class Batch {
+        friend class JobPool;
+        std::atomic<size_t> m_Pending{0};
+
+      public:
+        bool done() const { return m_Pending.load() == 0; }
+    };
+
+  private:
+    std::vector<std::unique_ptr<Worker>> m_Workers;
+    std::vector<std::thread> m_Threads;
+
+    std::atomic<size_t> m_Pending{0};
+    std::atomic<size_t> m_Queued{0};
+    std::atomic<unsigned> m_NextWorker{0};
+
+    std::mutex m_SleepMutex;
+    std::condition_variable m_WakeUp;
+    std::condition_variable m_Done;
+    bool m_Running = false;
+
+  public:
+    explicit JobPool(unsigned threads = defaultThreadCount());
+    ~JobPool();
+
+    JobPool(const JobPool &) = delete;
+    JobPool &operator=(const JobPool &) = delete;
+
+    void submit(Job job);
+    void submit(Job job, Batch &batch);
+    void parallelFor(size_t count, size_t chunkSize, const RangeJob &job);
+    void parallelFor(size_t count, size_t chunkSize, const RangeJob &job, Batch &batch);
+
+    // Runs jobs on the calling thread until every submitted job is done.
+    void wait();
+    // Runs jobs on the calling thread until the jobs of batch are done.
+    void wait(const Batch &batch);
+
+    void setThreadCount(unsigned threads);
+    unsigned getThreadCount() const { return static_cast<unsigned>(m_Threads.size()); }
+    unsigned getSlotCount() const { return static_cast<unsigned>(m_Workers.size()); }
+
+    std::vector<WorkerStats> getStats() const;
+    void resetStats();
+
+    static unsigned defaultThreadCount();
+
+  private:
+    void start(unsigned threads);
+    void stop();
+    void workerLoop(unsigned worker);
+    bool tryRun(unsigned worker);
+    bool takeJob(unsigned worker, Job &job);
+    void waitUntil(const std::atomic<size_t> &pending);
+};
+
+} // namespace Engine
@@ -0,0 +1,121 @@
+#include "MappedFile.hpp"
+
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ENGINE_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine {
+
+namespace {
+
+// Stands in for the data of empty files, which cannot be mapped.
+const char c_Empty[1] = {0};
+
+} // namespace
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_Data(std::exchange(other.m_Data, nullptr)), m_Size(std::exchange(other.m_Size, 0)),
+      m_Mapped(std::exchange(other.m_Mapped, false)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        close();
+        m_Data = std::exchange(other.m_Data, nullptr);
+        m_Size = std::exchange(other.m_Size, 0);
+        m_Mapped = std::exchange(other.m_Mapped, false);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string &path) {
+    close();
+
+#ifdef ENGINE_HAS_MMAP
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(descriptor, &info) != 0) {
+        ::close(descriptor);
+        return false;
+    }
+
+    m_Size = static_cast<size_t>(info.st_size);
+    if (m_Size == 0) {
+        ::close(descriptor);
+        m_Data = c_Empty;
+        return true;
+    }
+
+    void *data = ::mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    // The mapping keeps its own reference to the file.
+    ::close(descriptor);
+
+    if (data == MAP_FAILED) {
+        m_Size = 0;
+        return false;
+    }
+
+    m_Data = static_cast<const char *>(data);
+    m_Mapped = true;
+    return true;
+#else
+    std::ifstream in(path, std::ios_base::binary | std::ios_base::ate);
+    if (!in) {
+        return false;
+    }
+
+    m_Size = static_cast<size_t>(in.tellg());
+    if (m_Size == 0) {
+        m_Data = c_Empty;
+        return true;
+    }
+
+    char *buffer = new char[m_Size];
+    in.seekg(0, std::ios_base::beg);
+    if (!in.read(buffer, static_cast<std::streamsize>(m_Size))) {
+        delete[] buffer;
+        m_Size = 0;
+        return false;
+    }
+
+    m_Data = buffer;
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+    if (m_Data != nullptr && m_Data != c_Empty) {
+#ifdef ENGINE_HAS_MMAP
+        ::munmap(const_cast<char *>(m_Data), m_Size);
+#else
+        delete[] m_Data;
+#endif
+    }
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_Mapped = false;
+}
+
+void MappedFile::adviseSequential() const {
+#ifdef ENGINE_HAS_MMAP
+    if (m_Mapped) {
+        ::madvise(const_cast<char *>(m_Data), m_Size, MADV_SEQUENTIAL);
+        ::madvise(const_cast<char *>(m_Data), m_Size, MADV_WILLNEED);
+    }
+#endif
+}
+
+} // namespace Engine
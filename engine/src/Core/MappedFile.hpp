@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Engine {
+
+/**
+ * Read-only view of a whole file mapped into memory. Pages are loaded by the
+ * OS on first touch, so opening is cheap no matter the file size, and the
+ * data stays valid until close() or destruction.
+ *
+ * Where mmap is not available the file is read into an owned buffer instead.
+ */
+class MappedFile {
+  private:
+    const char *m_Data = nullptr;
+    size_t m_Size = 0;
+    bool m_Mapped = false;
+
+  public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string &path) { open(path); }
+    ~MappedFile();
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return m_Data != nullptr; }
+    const char *data() const { return m_Data; }
+    size_t size() const { return m_Size; }
+
+    // Tells the OS the whole file is about to be read front to back.
+    void adviseSequential() const;
+};
+
+} // namespace Engine
@@ -4,6 +4,16 @@
 
 namespace Engine::Math {
 
+namespace {
+Random s_Random;
+} // namespace
+
+Random &getRandom() { return s_Random; }
+
+uint64_t getSeed() { return s_Random.getSeed(); }
+
+void srand(uint64_t seed) { s_Random = Random(seed); }
+
 glm::vec3 getDirection(glm::vec3 rotation) {
     glm::vec3 direction;
 
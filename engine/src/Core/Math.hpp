@@ -4,13 +4,16 @@
 #include <glm/vec3.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include "Random.hpp"
+
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
-#include <ctime>
 
 namespace Engine::Math {
 
 const float c_Epsilon = 0.00001f;
+const float c_Pi = 3.14159265f;
 
 glm::vec3 getDirection(glm::vec3 rotation);
 
@@ -23,9 +26,13 @@ inline bool isEqual(glm::vec3 v0, glm::vec3 v1) {
     return isEqual(v0.x, v1.x) && isEqual(v0.y, v1.y) && isEqual(v0.z, v1.z);
 }
 
-inline void srand() { std::srand(static_cast<unsigned>(std::time(0))); }
+// Shared generator for main-thread helpers; not thread-safe. Parallel code
+// should create its own Random streams from getSeed().
+Random &getRandom();
+uint64_t getSeed();
+void srand(uint64_t seed);
 
-inline float randFloat() { return static_cast<float>(rand()) / static_cast<float>(RAND_MAX); }
+inline float randFloat() { return getRandom().nextFloat(); }
 
 inline float rand(int max) { 
     return static_cast<int>(max * randFloat());
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine {
+
+/**
+ * Counter-based random generator (Philox4x32-10). Output is a pure function
+ * of (seed, stream, counter), so independent streams can be handed out per
+ * particle or per thread and results do not depend on scheduling.
+ */
+class Random {
+  public:
+    using Block = std::array<uint32_t, 4>;
+
+  private:
+    uint64_t m_Seed;
+    uint64_t m_Stream;
+    uint64_t m_Counter = 0;
+
+    Block m_Block{};
+    int m_Index = 4;
+
+  public:
+    // Per-thread streams live in the upper half of the stream space so they never meet per-item streams.
+    static constexpr uint64_t c_ThreadStreams = uint64_t(1) << 63;
+
+    explicit Random(uint64_t seed = 0, uint64_t stream = 0) : m_Seed(seed), m_Stream(stream) {}
+
+    static Random forThread(uint64_t seed, unsigned thread) { return Random(seed, c_ThreadStreams | thread); }
+
+    uint32_t next() {
+        if (m_Index == 4) {
+            m_Block = generate(m_Seed, m_Stream, m_Counter++);
+            m_Index = 0;
+        }
+        return m_Block[m_Index++];
+    }
+
+    // Uniform in [0, 1)
+    float nextFloat() { return toFloat(next()); }
+
+    // Uniform in [0, bound)
+    uint32_t nextBelow(uint32_t bound) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(next()) * bound) >> 32);
+    }
+
+    void fillUniform(float *values, size_t count) {
+        size_t i = 0;
+        for (; i < count && m_Index != 4; i++) {
+            values[i] = nextFloat();
+        }
+
+        for (; i + 4 <= count; i += 4) {
+            Block block = generate(m_Seed, m_Stream, m_Counter++);
+            for (int k = 0; k < 4; k++) {
+                values[i + k] = toFloat(block[k]);
+            }
+        }
+
+        for (; i < count; i++) {
+            values[i] = nextFloat();
+        }
+    }
+
+    uint64_t getSeed() const { return m_Seed; }
+    uint64_t getStream() const { return m_Stream; }
+
+    static float toFloat(uint32_t value) { return static_cast<float>(value >> 8) * (1.0f / 16777216.0f); }
+
+    static Block generate(uint64_t seed, uint64_t stream, uint64_t counter) {
+        Block block = {static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+                       static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)};
+        uint32_t key0 = static_cast<uint32_t>(seed);
+        uint32_t key1 = static_cast<uint32_t>(seed >> 32);
+
+        for (int round = 0; round < 10; round++) {
+            uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * block[0];
+            uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * block[2];
+
+            block = {static_cast<uint32_t>(product1 >> 32) ^ block[1] ^ key0, static_cast<uint32_t>(product1),
+                     static_cast<uint32_t>(product0 >> 32) ^ block[3] ^ key1, static_cast<uint32_t>(product0)};
+
+            key0 += 0x9E3779B9u;
+            key1 += 0xBB67AE85u;
+        }
+
+        return block;
+    }
+};
+
+} // namespace Engine
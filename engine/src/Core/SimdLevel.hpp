@@ -0,0 +1,8 @@
+#pragma once
+
+namespace Engine {
+
+// Instruction sets the batch kernels can be built for; see SurfaceKernels::detect().
+enum class SimdLevel { Scalar, SSE4, AVX2 };
+
+} // namespace Engine
@@ -0,0 +1,145 @@
+#include "SpatialHashGrid.hpp"
+
+namespace Engine {
+
+void SpatialHashGrid::build(const float *x, const float *y, const float *z, size_t count) {
+    // About two buckets per point keeps collisions rare without hurting locality.
+    size_t buckets = 16;
+    while (buckets < count * 2) {
+        buckets <<= 1;
+    }
+    m_Mask = buckets - 1;
+
+    m_Buckets.resize(count);
+    m_BucketStarts.assign(buckets + 1, 0);
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t bucket = bucketOf(glm::vec3(x[i], y[i], z[i]));
+        m_Buckets[i] = bucket;
+        m_BucketStarts[bucket + 1]++;
+    }
+
+    for (size_t b = 0; b < buckets; b++) {
+        m_BucketStarts[b + 1] += m_BucketStarts[b];
+    }
+
+    // Scatter in index order, moving each bucket start forward as it fills,
+    // then shift the starts back by one bucket.
+    m_Indices.resize(count);
+    m_Points.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t slot = m_BucketStarts[m_Buckets[i]]++;
+        m_Indices[slot] = static_cast<uint32_t>(i);
+        m_Points[slot] = glm::vec3(x[i], y[i], z[i]);
+    }
+
+    for (size_t b = buckets; b > 0; b--) {
+        m_BucketStarts[b] = m_BucketStarts[b - 1];
+    }
+    m_BucketStarts[0] = 0;
+}
+
+void SpatialHashGrid::clear() {
+    m_Mask = 0;
+    m_BucketStarts.clear();
+    m_Indices.clear();
+    m_Points.clear();
+    m_Buckets.clear();
+}
+
+size_t SpatialHashGrid::findInRadius(glm::vec3 center, float radius, std::vector<uint32_t> &indices) const {
+    indices.clear();
+    forEachInRadius(center, radius,
+                    [&indices](uint32_t index, const glm::vec3 &, float) { indices.push_back(index); });
+    return indices.size();
+}
+
+size_t SpatialHashGrid::findNearest(glm::vec3 center, size_t count, float maxRadius,
+                                    std::vector<uint32_t> &indices) const {
+    indices.clear();
+    if (count == 0 || m_Indices.empty() || !(maxRadius >= 0.0f)) {
+        return 0;
+    }
+
+    // Max-heap on distance holding the best count points so far.
+    float maxRadiusSquared = maxRadius * maxRadius;
+    std::vector<std::pair<float, uint32_t>> nearest;
+    nearest.reserve(std::min(count, m_Indices.size()));
+    auto consider = [&](uint32_t slot) {
+        glm::vec3 offset = m_Points[slot] - center;
+        float distanceSquared = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+        if (!(distanceSquared <= maxRadiusSquared)) {
+            return;
+        }
+        if (nearest.size() < count) {
+            nearest.emplace_back(distanceSquared, m_Indices[slot]);
+            std::push_heap(nearest.begin(), nearest.end());
+        } else if (distanceSquared < nearest.front().first) {
+            std::pop_heap(nearest.begin(), nearest.end());
+            nearest.back() = {distanceSquared, m_Indices[slot]};
+            std::push_heap(nearest.begin(), nearest.end());
+        }
+    };
+    auto scanAll = [&]() {
+        nearest.clear();
+        for (uint32_t slot = 0; slot < m_Indices.size(); slot++) {
+            consider(slot);
+        }
+    };
+
+    glm::vec3 cell = cellOf(center);
+    if (!inCellRange(cell)) {
+        scanAll();
+    } else {
+        int32_t cx = static_cast<int32_t>(cell.x);
+        int32_t cy = static_cast<int32_t>(cell.y);
+        int32_t cz = static_cast<int32_t>(cell.z);
+
+        for (int32_t ring = 0;; ring++) {
+            size_t side = static_cast<size_t>(ring) * 2 + 1;
+            if (side * side * side > bucketCount()) {
+                // The rings now cover more cells than there are buckets.
+                scanAll();
+                break;
+            }
+
+            // Only the shell of the ring is new. Buckets are shared between
+            // cells, so points of other cells in them are left for their own ring.
+            for (int32_t z = cz - ring; z <= cz + ring; z++) {
+                for (int32_t y = cy - ring; y <= cy + ring; y++) {
+                    bool face = z == cz - ring || z == cz + ring || y == cy - ring || y == cy + ring;
+                    int32_t step = face || ring == 0 ? 1 : ring * 2;
+                    for (int32_t x = cx - ring; x <= cx + ring; x += step) {
+                        uint32_t bucket = bucketOf(x, y, z);
+                        for (uint32_t slot = m_BucketStarts[bucket]; slot < m_BucketStarts[bucket + 1]; slot++) {
+                            glm::vec3 point = cellOf(m_Points[slot]);
+                            if (cellIndex(point.x) == x && cellIndex(point.y) == y && cellIndex(point.z) == z) {
+                                consider(slot);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Points in the next ring are at least this far from center.
+            float reached = static_cast<float>(ring) * m_CellSize;
+            if (reached >= maxRadius || (nearest.size() == count && nearest.front().first <= reached * reached)) {
+                break;
+            }
+        }
+    }
+
+    std::sort_heap(nearest.begin(), nearest.end());
+    indices.resize(nearest.size());
+    for (size_t i = 0; i < nearest.size(); i++) {
+        indices[i] = nearest[i].second;
+    }
+    return indices.size();
+}
+
+size_t SpatialHashGrid::memoryUsage() const {
+    return m_BucketStarts.capacity() * sizeof(uint32_t) + m_Indices.capacity() * sizeof(uint32_t) +
+           m_Points.capacity() * sizeof(glm::vec3) + m_Buckets.capacity() * sizeof(uint32_t);
+}
+
+} // namespace Engine
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Sparse 3D spatial hash for neighbour queries over point sets. The 3D,
+ * float-coordinate counterpart of SpatialMap: space is cut into cubic cells
+ * of getCellSize(), and cells are hashed into a table sized to the point
+ * count, so the extent is unbounded and memory does not depend on it.
+ *
+ * build() takes a snapshot: points are counting-sorted by bucket and copied,
+ * so queries read only the grid and stay valid while the source arrays are
+ * written to, e.g. by a parallel update.
+ */
+class SpatialHashGrid {
+  private:
+    float m_CellSize = 1.0f;
+    float m_InverseCellSize = 1.0f;
+    size_t m_Mask = 0;
+
+    // Bucket b holds the sorted entries [m_BucketStarts[b], m_BucketStarts[b + 1]).
+    std::vector<uint32_t> m_BucketStarts;
+    std::vector<uint32_t> m_Indices;
+    std::vector<glm::vec3> m_Points;
+    std::vector<uint32_t> m_Buckets;
+
+    // Bucket lists for queries covering at most this many cells live on the stack.
+    static constexpr size_t c_InlineBuckets = 64;
+
+    // Cell coordinates are converted to int32 only within this range; points
+    // beyond it share the outermost cells and queries reaching it scan.
+    static constexpr float c_MaxCell = 1073741824.0f;
+
+  public:
+    explicit SpatialHashGrid(float cellSize = 1.0f) { setCellSize(cellSize); }
+
+    /**
+     * Takes effect on the next build(). Queries are cheapest when the cell
+     * size is about twice the usual query radius: a query then touches at
+     * most 2 cells per axis.
+     */
+    void setCellSize(float cellSize) {
+        m_CellSize = cellSize;
+        m_InverseCellSize = 1.0f / cellSize;
+    }
+    float getCellSize() const { return m_CellSize; }
+
+    void build(const float *x, const float *y, const float *z, size_t count);
+    void clear();
+
+    bool empty() const { return m_Indices.empty(); }
+    size_t size() const { return m_Indices.size(); }
+    size_t bucketCount() const { return m_Mask + 1; }
+
+    // Points in bucket order. Queries around consecutive slots touch the same
+    // buckets, so walking slots in order is much kinder to the cache.
+    uint32_t indexAt(size_t slot) const { return m_Indices[slot]; }
+    const glm::vec3 &pointAt(size_t slot) const { return m_Points[slot]; }
+
+    /**
+     * Calls consumer(index, point, distanceSquared) for every point within
+     * radius of center, with point as it was at build(). Each point is
+     * reported once, in no particular order.
+     */
+    template <typename TConsumer> void forEachInRadius(glm::vec3 center, float radius, TConsumer consumer) const {
+        if (m_Indices.empty()) {
+            return;
+        }
+
+        glm::vec3 low = cellOf(center - glm::vec3(radius));
+        glm::vec3 high = cellOf(center + glm::vec3(radius));
+        // In double so the count is exact; huge or non-finite extents fail the test below.
+        double cells = static_cast<double>(high.x - low.x + 1.0f) * static_cast<double>(high.y - low.y + 1.0f) *
+                       static_cast<double>(high.z - low.z + 1.0f);
+
+        if (!(cells < static_cast<double>(bucketCount())) || !inCellRange(low) || !inCellRange(high)) {
+            // Covers more cells than there are buckets: scanning every point is cheaper.
+            visitRange(0, static_cast<uint32_t>(m_Indices.size()), center, radius * radius, consumer);
+        } else if (cells <= c_InlineBuckets) {
+            std::array<uint32_t, c_InlineBuckets> buckets;
+            size_t count = collectBuckets(low, high, buckets.data());
+            visitBuckets(buckets.data(), count, center, radius * radius, consumer);
+        } else {
+            std::vector<uint32_t> buckets(static_cast<size_t>(cells));
+            size_t count = collectBuckets(low, high, buckets.data());
+            visitBuckets(buckets.data(), count, center, radius * radius, consumer);
+        }
+    }
+
+    size_t findInRadius(glm::vec3 center, float radius, std::vector<uint32_t> &indices) const;
+
+    /**
+     * Up to count nearest points within maxRadius of center, closest first.
+     * Searches rings of cells outwards from the cell of center and stops
+     * once count points are found and the next ring is farther than the
+     * last of them, or farther than maxRadius.
+     */
+    size_t findNearest(glm::vec3 center, size_t count, float maxRadius, std::vector<uint32_t> &indices) const;
+    size_t findNearest(glm::vec3 center, size_t count, std::vector<uint32_t> &indices) const {
+        return findNearest(center, count, std::numeric_limits<float>::infinity(), indices);
+    }
+
+    size_t memoryUsage() const;
+
+  private:
+    glm::vec3 cellOf(glm::vec3 point) const {
+        return glm::vec3(std::floor(point.x * m_InverseCellSize), std::floor(point.y * m_InverseCellSize),
+                         std::floor(point.z * m_InverseCellSize));
+    }
+
+    // Only the (y, z) row is hashed and x is added on top, so cells next to
+    // each other along x land in neighbouring buckets and a query reads a few
+    // short runs of memory instead of one random location per cell.
+    uint32_t bucketOf(int32_t x, int32_t y, int32_t z) const {
+        uint32_t row = static_cast<uint32_t>(y) * 19349663u ^ static_cast<uint32_t>(z) * 83492791u;
+        return static_cast<uint32_t>((row + static_cast<uint32_t>(x)) & m_Mask);
+    }
+
+    uint32_t bucketOf(glm::vec3 point) const {
+        glm::vec3 cell = cellOf(point);
+        return bucketOf(cellIndex(cell.x), cellIndex(cell.y), cellIndex(cell.z));
+    }
+
+    // Clamps to the convertible range; NaN goes to the lowest cell.
+    static int32_t cellIndex(float cell) {
+        if (cell >= c_MaxCell) {
+            return static_cast<int32_t>(c_MaxCell);
+        }
+        return cell >= -c_MaxCell ? static_cast<int32_t>(cell) : -static_cast<int32_t>(c_MaxCell);
+    }
+
+    static bool inCellRange(glm::vec3 cell) {
+        return std::abs(cell.x) <= c_MaxCell && std::abs(cell.y) <= c_MaxCell && std::abs(cell.z) <= c_MaxCell;
+    }
+
+    // Distinct cells can share a bucket; returns the distinct buckets so no point is visited twice.
+    size_t collectBuckets(glm::vec3 low, glm::vec3 high, uint32_t *buckets) const {
+        size_t count = 0;
+        for (int32_t z = static_cast<int32_t>(low.z); z <= static_cast<int32_t>(high.z); z++) {
+            for (int32_t y = static_cast<int32_t>(low.y); y <= static_cast<int32_t>(high.y); y++) {
+                for (int32_t x = static_cast<int32_t>(low.x); x <= static_cast<int32_t>(high.x); x++) {
+                    buckets[count++] = bucketOf(x, y, z);
+                }
+            }
+        }
+
+        std::sort(buckets, buckets + count);
+        return static_cast<size_t>(std::unique(buckets, buckets + count) - buckets);
+    }
+
+    template <typename TConsumer>
+    void visitBuckets(const uint32_t *buckets, size_t count, glm::vec3 center, float radiusSquared,
+                      TConsumer &consumer) const {
+        for (size_t b = 0; b < count; b++) {
+            visitRange(m_BucketStarts[buckets[b]], m_BucketStarts[buckets[b] + 1], center, radiusSquared, consumer);
+        }
+    }
+
+    template <typename TConsumer>
+    void visitRange(uint32_t begin, uint32_t end, glm::vec3 center, float radiusSquared, TConsumer &consumer) const {
+        for (uint32_t i = begin; i < end; i++) {
+            glm::vec3 offset = m_Points[i] - center;
+            float distanceSquared = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+            if (distanceSquared <= radiusSquared) {
+                consumer(m_Indices[i], m_Points[i], distanceSquared);
+            }
+        }
+    }
+};
+
+} // namespace Engine
@@ -1,6 +1,7 @@
 #include "Time.hpp"
 
 #include <chrono>
+#include <cmath>
 
 namespace Engine {
 
@@ -19,6 +20,22 @@ void Time::tick() {
     m_LastFrameTime = seconds;
 }
 
+int Time::advanceFixedSteps() {
+    m_Accumulator += m_deltaTime;
+
+    int steps = static_cast<int>(m_Accumulator / m_FixedStep);
+    if (steps > m_MaxFixedSteps) {
+        steps = m_MaxFixedSteps;
+        m_Accumulator = std::fmod(m_Accumulator, m_FixedStep) + steps * m_FixedStep;
+    }
+
+    m_Accumulator -= steps * m_FixedStep;
+    m_Interpolation = m_Accumulator / m_FixedStep;
+    m_FixedStepCount += steps;
+
+    return steps;
+}
+
 void Time::play() { m_Stop = false; }
 
 void Time::stop() {
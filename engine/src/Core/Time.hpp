@@ -9,14 +9,33 @@ class Time {
     double m_LastFrameTime = 0;
     float m_Stop = false;
 
+    double m_FixedStep = 1.0 / 240.0;
+    double m_Accumulator = 0;
+    double m_Interpolation = 0;
+    int m_MaxFixedSteps = 8;
+    unsigned long long m_FixedStepCount = 0;
+
   public:
     void tick();
     void play();
     void stop();
 
+    // Number of fixed steps due after the last tick(). Backlog beyond
+    // getMaxFixedSteps() is dropped so a long stall cannot snowball.
+    int advanceFixedSteps();
+
     bool poused() { return m_Stop; }
     double getDeltaSeconds() const { return m_deltaTime; }
     double getTotalSeconds() const { return m_totalTime; }
+
+    void setFixedStep(double seconds) { m_FixedStep = seconds; }
+    double getFixedStep() const { return m_FixedStep; }
+    void setMaxFixedSteps(int steps) { m_MaxFixedSteps = steps; }
+    int getMaxFixedSteps() const { return m_MaxFixedSteps; }
+    unsigned long long getFixedStepCount() const { return m_FixedStepCount; }
+
+    // Fraction of a fixed step between the last simulated state and now, in [0, 1)
+    double getInterpolation() const { return m_Interpolation; }
 };
 
 } // namespace Engine
\ No newline at end of file
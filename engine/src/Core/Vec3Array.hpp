@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Array of 3D vectors stored as three separate component arrays.
+ */
+struct Vec3Array {
+    std::vector<float> x, y, z;
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    void resize(size_t size) {
+        x.resize(size);
+        y.resize(size);
+        z.resize(size);
+    }
+
+    void reserve(size_t capacity) {
+        x.reserve(capacity);
+        y.reserve(capacity);
+        z.reserve(capacity);
+    }
+
+    void clear() {
+        x.clear();
+        y.clear();
+        z.clear();
+    }
+
+    glm::vec3 get(size_t i) const { return glm::vec3(x[i], y[i], z[i]); }
+
+    void set(size_t i, glm::vec3 value) {
+        x[i] = value.x;
+        y[i] = value.y;
+        z[i] = value.z;
+    }
+
+    size_t memoryUsage() const { return (x.capacity() + y.capacity() + z.capacity()) * sizeof(float); }
+};
+
+} // namespace Engine
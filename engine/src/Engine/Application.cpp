@@ -1,9 +1,11 @@
 #include "Application.hpp"
 
+#include "GpuResources.hpp"
 #include "Math.hpp"
 
 #include <chrono>
 #include <cmath>
+#include <ctime>
 #include <iostream>
 #include <thread>
 
@@ -29,12 +31,15 @@ Application::Application() {
 
     m_CameraController = std::make_unique<CameraController>(*m_Camera);
 
+    m_JobPool = std::make_unique<JobPool>();
+    m_ModelStreamer = std::make_unique<ModelStreamer>();
+
+    setSeed(static_cast<uint64_t>(std::time(nullptr)));
+
     s_Instance = this;
 }
 
 void Application::run() {
-    Math::srand();
-    
     m_Time.tick();
 
     while (m_Running) {
@@ -44,6 +49,16 @@ void Application::run() {
         m_Input->update();
         m_CameraController->update(m_Time.getDeltaSeconds());
 
+        // Simulation runs at a fixed rate independent of the frame rate; each
+        // step may use the job pool and must finish before the next one starts.
+        int fixedSteps = m_Time.advanceFixedSteps();
+        for (int step = 0; step < fixedSteps; step++) {
+            for (auto layer : m_LayerStack) {
+                layer->fixedUpdate();
+            }
+            m_JobPool->wait();
+        }
+
         for (auto layer : m_LayerStack) {
             layer->update();
 
@@ -52,6 +67,12 @@ void Application::run() {
             }
         }
 
+        // Layers may leave jobs running during update; they must be done before anything is drawn.
+        m_JobPool->wait();
+
+        // Models imported in the background reach the GPU a few meshes per frame.
+        m_ModelStreamer->upload();
+
         m_Render->clear();
         m_Render->begin();
         for (auto layer : m_LayerStack) {
@@ -66,6 +87,11 @@ void Application::run() {
 
 void Application::stop() { m_Running = false; }
 
+void Application::setSeed(uint64_t seed) {
+    m_Seed = seed;
+    Math::srand(seed);
+}
+
 void Application::onMouseEvent(MouseEvent &e) {
     for (auto it = m_LayerStack.rbegin(); it != m_LayerStack.rend(); ++it) {
         (*it)->onMouseEvent(e);
@@ -91,9 +117,18 @@ void Application::onWindowEvent(WindowEvent &e) {
 }
 
 Application::~Application() {
+    m_JobPool->wait();
+
     for (auto layer : m_LayerStack) {
         layer->onDetach();
     }
+
+    // GL objects have to go while the context is still there; what is left after that leaked.
+    m_NameToLayer.clear();
+    m_LayerStack.clear();
+    m_ModelStreamer.reset();
+    GpuResources::reportLeaks();
+
     m_Window->shutDown();
 }
 
@@ -3,11 +3,14 @@
 #include "Camera.hpp"
 #include "CameraController.hpp"
 #include "Input.hpp"
+#include "JobPool.hpp"
 #include "Layer.hpp"
 #include "MasterRenderer.hpp"
+#include "ModelStreamer.hpp"
 #include "Time.hpp"
 #include "Window.hpp"
 
+#include <cstdint>
 #include <iterator>
 #include <list>
 #include <memory>
@@ -26,9 +29,12 @@ class Application {
     std::unique_ptr<MasterRenderer> m_Render;
     std::unique_ptr<Camera> m_Camera;
     std::unique_ptr<CameraController> m_CameraController;
+    std::unique_ptr<JobPool> m_JobPool;
+    std::unique_ptr<ModelStreamer> m_ModelStreamer;
     std::list<std::shared_ptr<Layer>> m_LayerStack;
     std::unordered_map<std::string, std::list<std::shared_ptr<Layer>>::iterator> m_NameToLayer;
     Time m_Time;
+    uint64_t m_Seed;
 
     bool m_Running = true;
 
@@ -43,6 +49,10 @@ class Application {
     void run();
     void stop();
 
+    // Seed of every engine random stream; set before run() for reproducible runs.
+    void setSeed(uint64_t seed);
+    uint64_t getSeed() const { return m_Seed; }
+
     template <typename T> T &addLayer(const std::string &label) {
         auto layer = std::make_shared<T>(label);
         m_LayerStack.push_back(layer);
@@ -68,6 +78,9 @@ class Application {
     MasterRenderer &getRender() { return *m_Render; }
     Camera &getCamera() { return *m_Camera; }
     CameraController &getCameraController() { return *m_CameraController; }
+    JobPool &getJobPool() { return *m_JobPool; }
+    // Pass to ModelLoader::loadAsync(); run() uploads its meshes within the streamer's frame budget.
+    ModelStreamer &getModelStreamer() { return *m_ModelStreamer; }
     Time &getTime() { return m_Time; }
     Layer &getLayer(const std::string &label) { return **m_NameToLayer[label]; }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Application.hpp"
+#include "BarycentricParticleSystem.hpp"
 #include "Layer.hpp"
 #include "TextureLoader.hpp"
 #include "Model.hpp"
@@ -11,4 +12,8 @@
 #include "Camera.hpp"
 #include "CameraController.hpp"
 #include "Input.hpp"
-#include "Math.hpp"
\ No newline at end of file
+#include "Math.hpp"
+#include "Frustum.hpp"
+#include "GpuResources.hpp"
+#include "SpatialHashGrid.hpp"
+#include "SurfaceParticleSystem.hpp"
\ No newline at end of file
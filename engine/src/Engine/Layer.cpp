@@ -9,6 +9,8 @@ void Layer::attach() {
     m_Active = true;
 }
 
+void Layer::fixedUpdate() { onFixedUpdate(); }
+
 void Layer::update() {
     onUpdate();
 }
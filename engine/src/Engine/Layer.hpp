@@ -20,6 +20,7 @@ class Layer {
     bool isActive() { return m_Active; }
 
     void attach();
+    void fixedUpdate();
     void update();
     void draw();
     void detach();
@@ -27,6 +28,7 @@ class Layer {
     std::string &getName() { return m_Name; }
 
     virtual void onAttach() {}
+    virtual void onFixedUpdate() {}
     virtual void onUpdate() {}
     virtual void onDraw() {}
     virtual void onDetach() {}
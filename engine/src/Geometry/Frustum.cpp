@@ -0,0 +1,144 @@
+#include "Frustum.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ENGINE_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define ENGINE_SIMD_X86 0
+#endif
+
+namespace Engine {
+
+namespace {
+
+size_t cullSpheresScalar(const Frustum &frustum, const float *x, const float *y, const float *z, size_t begin,
+                         size_t end, float radius, uint32_t *visible) {
+    size_t written = 0;
+    for (size_t i = begin; i < end; i++) {
+        visible[written] = static_cast<uint32_t>(i);
+        written += frustum.intersectsSphere(glm::vec3(x[i], y[i], z[i]), radius);
+    }
+    return written;
+}
+
+#if ENGINE_SIMD_X86
+
+__attribute__((target("avx2,fma"))) size_t cullSpheresAVX2(const Frustum &frustum, const float *x, const float *y,
+                                                           const float *z, size_t count, float radius,
+                                                           uint32_t *visible) {
+    __m256 px[6], py[6], pz[6], pw[6];
+    for (int k = 0; k < 6; k++) {
+        px[k] = _mm256_set1_ps(frustum.planes[k].x);
+        py[k] = _mm256_set1_ps(frustum.planes[k].y);
+        pz[k] = _mm256_set1_ps(frustum.planes[k].z);
+        // Folding the radius into the offset turns the test into distance >= 0.
+        pw[k] = _mm256_set1_ps(frustum.planes[k].w + radius);
+    }
+
+    const __m256 zero = _mm256_setzero_ps();
+    size_t written = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 cx = _mm256_loadu_ps(x + i);
+        __m256 cy = _mm256_loadu_ps(y + i);
+        __m256 cz = _mm256_loadu_ps(z + i);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int k = 0; k < 6; k++) {
+            __m256 distance = _mm256_fmadd_ps(pz[k], cz, _mm256_fmadd_ps(py[k], cy, _mm256_fmadd_ps(px[k], cx, pw[k])));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+        }
+
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(inside));
+        while (mask != 0) {
+            visible[written++] = static_cast<uint32_t>(i) + static_cast<uint32_t>(__builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+
+    return written + cullSpheresScalar(frustum, x, y, z, i, count, radius, visible + written);
+}
+
+#endif
+
+} // namespace
+
+BoundingBox BoundingBox::fromVertices(const std::vector<Vertex> &vertices) {
+    BoundingBox box;
+    if (vertices.empty()) {
+        return box;
+    }
+
+    box.min = box.max = vertices[0].position;
+    for (const auto &vertex : vertices) {
+        box.min = glm::min(box.min, vertex.position);
+        box.max = glm::max(box.max, vertex.position);
+    }
+    return box;
+}
+
+Frustum Frustum::fromMatrix(const glm::mat4 &clip) {
+    // Gribb-Hartmann: each plane is the fourth row of the clip matrix plus or
+    // minus one of the other rows. glm is column-major, so row r is clip[c][r].
+    auto row = [&clip](int r) { return glm::vec4(clip[0][r], clip[1][r], clip[2][r], clip[3][r]); };
+
+    Frustum frustum;
+    frustum.planes[Left] = row(3) + row(0);
+    frustum.planes[Right] = row(3) - row(0);
+    frustum.planes[Bottom] = row(3) + row(1);
+    frustum.planes[Top] = row(3) - row(1);
+    frustum.planes[Near] = row(3) + row(2);
+    frustum.planes[Far] = row(3) - row(2);
+
+    for (auto &plane : frustum.planes) {
+        float length = glm::length(glm::vec3(plane.x, plane.y, plane.z));
+        if (length > 0.0f) {
+            plane /= length;
+        }
+    }
+
+    return frustum;
+}
+
+bool Frustum::intersectsSphere(glm::vec3 center, float radius) const {
+    for (const auto &plane : planes) {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::intersectsBox(const BoundingBox &box) const {
+    glm::vec3 center = box.center();
+    glm::vec3 extent = box.extent();
+
+    // Distance of the centre against the box's projected radius on the plane normal.
+    for (const auto &plane : planes) {
+        float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+        float reach = extent.x * std::abs(plane.x) + extent.y * std::abs(plane.y) + extent.z * std::abs(plane.z);
+        if (distance < -reach) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t Frustum::cullSpheres(SimdLevel level, const float *x, const float *y, const float *z, size_t count,
+                            float radius, uint32_t *visible) const {
+#if ENGINE_SIMD_X86
+    if (level == SimdLevel::AVX2) {
+        return cullSpheresAVX2(*this, x, y, z, count, radius, visible);
+    }
+#endif
+
+    return cullSpheresScalar(*this, x, y, z, 0, count, radius, visible);
+}
+
+} // namespace Engine
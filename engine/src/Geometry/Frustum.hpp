@@ -0,0 +1,54 @@
+#pragma once
+
+#include "SimdLevel.hpp"
+#include "Vertex.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+struct BoundingBox {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+    glm::vec3 extent() const { return (max - min) * 0.5f; }
+
+    static BoundingBox fromVertices(const std::vector<Vertex> &vertices);
+};
+
+/**
+ * The six clip planes of a view volume, with unit normals pointing inside:
+ * P is inside when dot(xyz, P) + w >= 0 for every plane.
+ *
+ * Planes are taken from a clip matrix (projection * view * model), so they
+ * are in whatever space that matrix starts from; pass the model matrix too
+ * to cull in model space without transforming the points.
+ */
+struct Frustum {
+    enum Plane { Left, Right, Bottom, Top, Near, Far };
+
+    glm::vec4 planes[6];
+
+    static Frustum fromMatrix(const glm::mat4 &clip);
+
+    bool intersectsSphere(glm::vec3 center, float radius) const;
+    bool intersectsBox(const BoundingBox &box) const;
+
+    /**
+     * Tests count spheres of equal radius, centres given as SoA arrays, and
+     * writes the indices of those touching the frustum to visible in
+     * increasing order. Returns how many were written; visible must have room
+     * for count indices.
+     */
+    size_t cullSpheres(SimdLevel level, const float *x, const float *y, const float *z, size_t count, float radius,
+                       uint32_t *visible) const;
+};
+
+} // namespace Engine
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Half-open range [begin, end) of edited vertices or indices.
+ */
+struct DirtyRange {
+    size_t begin = 0;
+    size_t end = 0;
+
+    bool empty() const { return begin >= end; }
+    size_t size() const { return empty() ? 0 : end - begin; }
+
+    void add(size_t first, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        if (empty()) {
+            begin = first;
+            end = first + count;
+        } else {
+            begin = std::min(begin, first);
+            end = std::max(end, first + count);
+        }
+    }
+
+    void clear() { begin = end = 0; }
+};
+
+/**
+ * What one Mesh::commitChanges() did to the CPU-side caches, as passed to
+ * change listeners. Each touched triangle is listed once, together with its
+ * corner positions from before the change, so dependent state can be carried
+ * over by its barycentric location.
+ */
+class MeshChange {
+  public:
+    DirtyRange vertices;
+    DirtyRange indices;
+
+    // Set when the vertex or triangle count changed and the caches were built
+    // from scratch. Triangle ids from before mean nothing and none are listed.
+    bool rebuilt = false;
+
+    std::vector<uint32_t> triangles;
+    std::vector<glm::vec3> previousCorners;
+
+    bool empty() const { return triangles.empty() && !rebuilt; }
+
+    bool contains(uint32_t triangle) const { return triangle < m_Slots.size() && m_Slots[triangle] != 0; }
+
+    // The three corners of a listed triangle before the change, nullptr if it is not listed
+    const glm::vec3 *previous(uint32_t triangle) const {
+        return contains(triangle) ? &previousCorners[(m_Slots[triangle] - 1) * 3] : nullptr;
+    }
+
+    // Returns false when the triangle is already listed.
+    bool add(uint32_t triangle, glm::vec3 P0, glm::vec3 P1, glm::vec3 P2) {
+        if (triangle >= m_Slots.size() || m_Slots[triangle] != 0) {
+            return false;
+        }
+
+        triangles.push_back(triangle);
+        m_Slots[triangle] = static_cast<uint32_t>(triangles.size());
+        previousCorners.push_back(P0);
+        previousCorners.push_back(P1);
+        previousCorners.push_back(P2);
+        return true;
+    }
+
+    // Empties the change for a mesh of triangleCount triangles. Costs only what the last change listed.
+    void reset(size_t triangleCount) {
+        for (uint32_t triangle : triangles) {
+            if (triangle < m_Slots.size()) {
+                m_Slots[triangle] = 0;
+            }
+        }
+        m_Slots.resize(triangleCount, 0);
+
+        triangles.clear();
+        previousCorners.clear();
+        vertices.clear();
+        indices.clear();
+        rebuilt = false;
+    }
+
+    size_t memoryUsage() const {
+        return triangles.capacity() * sizeof(uint32_t) + previousCorners.capacity() * sizeof(glm::vec3) +
+               m_Slots.capacity() * sizeof(uint32_t);
+    }
+
+  private:
+    // 1 + position in triangles, 0 when not listed
+    std::vector<uint32_t> m_Slots;
+};
+
+} // namespace Engine
@@ -0,0 +1,64 @@
+#include "MeshPositions.hpp"
+
+#include <algorithm>
+
+namespace Engine {
+
+void MeshPositions::build(const std::vector<Vertex> &vertices, const MeshTopology &topology) {
+    positions.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        positions[i] = vertices[i].position;
+    }
+
+    corners.resize(topology.triangleCount() * 3);
+    for (size_t triangle = 0; triangle < topology.triangleCount(); triangle++) {
+        writeTriangle(topology, triangle);
+    }
+}
+
+void MeshPositions::update(const std::vector<Vertex> &vertices, const MeshTopology &topology, size_t firstVertex,
+                           size_t vertexCount, size_t firstTriangle, size_t triangleCount) {
+    if (vertices.size() != positions.size() || corners.size() != topology.corners.size()) {
+        build(vertices, topology);
+        return;
+    }
+
+    size_t end = std::min(firstVertex + vertexCount, vertices.size());
+    for (size_t v = firstVertex; v < end; v++) {
+        if (vertices[v].position == positions[v]) {
+            continue;
+        }
+
+        positions[v] = vertices[v].position;
+        for (uint32_t i = topology.vertexTriangleStarts[v]; i < topology.vertexTriangleStarts[v + 1]; i++) {
+            uint32_t triangle = topology.vertexTriangles[i];
+            for (int k = 0; k < 3; k++) {
+                if (topology.corner(triangle, k) == v) {
+                    corners[triangle * 3 + k] = positions[v];
+                }
+            }
+        }
+    }
+
+    size_t last = std::min(firstTriangle + triangleCount, topology.triangleCount());
+    for (size_t triangle = firstTriangle; triangle < last; triangle++) {
+        writeTriangle(topology, triangle);
+    }
+}
+
+void MeshPositions::clear() {
+    positions.clear();
+    corners.clear();
+}
+
+size_t MeshPositions::memoryUsage() const {
+    return positions.capacity() * sizeof(glm::vec3) + corners.capacity() * sizeof(glm::vec3);
+}
+
+void MeshPositions::writeTriangle(const MeshTopology &topology, size_t triangle) {
+    for (int k = 0; k < 3; k++) {
+        corners[triangle * 3 + k] = positions[topology.corner(triangle, k)];
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "MeshTopology.hpp"
+#include "Vertex.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Tightly packed copies of the vertex positions, for CPU-side queries that
+ * would otherwise pull whole 68 byte vertices into cache to read 12 bytes.
+ *
+ * corners holds the three positions of every triangle next to each other,
+ * so reading a triangle touches one 36 byte run instead of three vertices
+ * found through the index array.
+ */
+class MeshPositions {
+  public:
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> corners;
+
+    void build(const std::vector<Vertex> &vertices, const MeshTopology &topology);
+
+    /**
+     * Re-reads the vertices in [firstVertex, firstVertex + vertexCount) and
+     * rewrites the corners of every triangle using them, then the corners of
+     * the triangles in [firstTriangle, firstTriangle + triangleCount), whose
+     * indices changed. The counts must be the ones of the last build().
+     */
+    void update(const std::vector<Vertex> &vertices, const MeshTopology &topology, size_t firstVertex,
+                size_t vertexCount, size_t firstTriangle, size_t triangleCount);
+    void clear();
+
+    bool empty() const { return corners.empty(); }
+
+    glm::vec3 corner(size_t triangle, int k) const { return corners[triangle * 3 + k]; }
+
+    size_t memoryUsage() const;
+
+  private:
+    void writeTriangle(const MeshTopology &topology, size_t triangle);
+};
+
+} // namespace Engine
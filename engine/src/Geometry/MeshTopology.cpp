@@ -0,0 +1,261 @@
+#include "MeshTopology.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+namespace Engine {
+
+namespace {
+
+struct PositionKey {
+    uint32_t x, y, z;
+
+    bool operator==(const PositionKey &other) const { return x == other.x && y == other.y && z == other.z; }
+};
+
+struct PositionKeyHash {
+    size_t operator()(const PositionKey &key) const {
+        uint64_t hash = key.x * 0x9E3779B97F4A7C15ull;
+        hash ^= key.y + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+        hash ^= key.z + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+        return static_cast<size_t>(hash);
+    }
+};
+
+uint32_t floatBits(float value) {
+    // -0.0 and 0.0 must weld together.
+    value += 0.0f;
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+uint64_t edgeKey(uint32_t a, uint32_t b) {
+    if (a > b) {
+        std::swap(a, b);
+    }
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+} // namespace
+
+void MeshTopology::build(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices) {
+    clear();
+
+    if (indices.size() > 0) {
+        corners.assign(indices.begin(), indices.begin() + (indices.size() / 3) * 3);
+    } else {
+        corners.resize((vertices.size() / 3) * 3);
+        for (size_t i = 0; i < corners.size(); i++) {
+            corners[i] = static_cast<uint32_t>(i);
+        }
+    }
+
+    std::unordered_map<PositionKey, uint32_t, PositionKeyHash> positionToId;
+    positionToId.reserve(vertices.size());
+    weldedVertices.resize(vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const auto &position = vertices[i].position;
+        PositionKey key{floatBits(position.x), floatBits(position.y), floatBits(position.z)};
+        auto result = positionToId.emplace(key, static_cast<uint32_t>(positionToId.size()));
+        weldedVertices[i] = result.first->second;
+    }
+    weldedVertexCount = positionToId.size();
+
+    size_t triangles = triangleCount();
+    neighbors.assign(triangles * 3, c_NoNeighbor);
+    neighborEdges.assign(triangles * 3, 0);
+    boundaryMask.assign(triangles, 0x7);
+
+    m_OpenEdges.reserve(triangles * 2);
+    for (size_t halfEdge = 0; halfEdge < triangles * 3; halfEdge++) {
+        link(static_cast<uint32_t>(halfEdge));
+    }
+    // Only boundary edges stay open, usually few.
+    m_OpenEdges.rehash(0);
+
+    buildIncidence();
+}
+
+void MeshTopology::update(const std::vector<unsigned int> &indices, size_t firstTriangle, size_t count) {
+    size_t end = std::min(firstTriangle + count, std::min(triangleCount(), indices.size() / 3));
+    if (firstTriangle >= end) {
+        return;
+    }
+
+    // Detach first and relink after all corners changed, so the edited
+    // triangles only ever pair up with their final neighbours.
+    for (size_t halfEdge = firstTriangle * 3; halfEdge < end * 3; halfEdge++) {
+        unlink(static_cast<uint32_t>(halfEdge));
+    }
+
+    std::vector<uint32_t> previous(corners.begin() + firstTriangle * 3, corners.begin() + end * 3);
+    for (size_t i = firstTriangle * 3; i < end * 3; i++) {
+        corners[i] = indices[i];
+    }
+
+    for (size_t halfEdge = firstTriangle * 3; halfEdge < end * 3; halfEdge++) {
+        link(static_cast<uint32_t>(halfEdge));
+    }
+
+    if (!patchIncidence(previous, firstTriangle)) {
+        buildIncidence();
+    }
+}
+
+bool MeshTopology::weldedEdge(uint32_t halfEdge, uint64_t &key) const {
+    uint32_t triangle = halfEdge / 3;
+    int edge = static_cast<int>(halfEdge % 3);
+
+    uint32_t a = weldedVertices[corner(triangle, edge)];
+    uint32_t b = weldedVertices[corner(triangle, (edge + 1) % 3)];
+    key = edgeKey(a, b);
+    return a != b;
+}
+
+// Pairs the half-edge with the open one on the same welded edge, or leaves it
+// open itself. Non-manifold edges pair up two at a time.
+void MeshTopology::link(uint32_t halfEdge) {
+    uint64_t key;
+    if (!weldedEdge(halfEdge, key)) {
+        return;
+    }
+
+    auto result = m_OpenEdges.emplace(key, halfEdge);
+    if (result.second) {
+        return;
+    }
+
+    uint32_t other = result.first->second;
+    uint32_t triangle = halfEdge / 3;
+    if (other / 3 == triangle) {
+        return;
+    }
+    m_OpenEdges.erase(result.first);
+
+    neighbors[other] = static_cast<int32_t>(triangle);
+    neighborEdges[other] = static_cast<uint8_t>(halfEdge % 3);
+    boundaryMask[other / 3] &= static_cast<uint8_t>(~(1u << (other % 3)));
+
+    neighbors[halfEdge] = static_cast<int32_t>(other / 3);
+    neighborEdges[halfEdge] = static_cast<uint8_t>(other % 3);
+    boundaryMask[triangle] &= static_cast<uint8_t>(~(1u << (halfEdge % 3)));
+}
+
+// Reopens the half-edge, and relinks its old partner, which may find another one.
+void MeshTopology::unlink(uint32_t halfEdge) {
+    int32_t neighbor = neighbors[halfEdge];
+    uint32_t other = static_cast<uint32_t>(neighbor) * 3 + neighborEdges[halfEdge];
+
+    neighbors[halfEdge] = c_NoNeighbor;
+    neighborEdges[halfEdge] = 0;
+    boundaryMask[halfEdge / 3] |= static_cast<uint8_t>(1u << (halfEdge % 3));
+
+    if (neighbor != c_NoNeighbor) {
+        neighbors[other] = c_NoNeighbor;
+        neighborEdges[other] = 0;
+        boundaryMask[other / 3] |= static_cast<uint8_t>(1u << (other % 3));
+        link(other);
+        return;
+    }
+
+    uint64_t key;
+    if (weldedEdge(halfEdge, key)) {
+        auto open = m_OpenEdges.find(key);
+        if (open != m_OpenEdges.end() && open->second == halfEdge) {
+            m_OpenEdges.erase(open);
+        }
+    }
+}
+
+void MeshTopology::buildIncidence() {
+    vertexTriangleStarts.assign(weldedVertices.size() + 1, 0);
+    for (uint32_t vertex : corners) {
+        vertexTriangleStarts[vertex + 1]++;
+    }
+    for (size_t v = 0; v < weldedVertices.size(); v++) {
+        vertexTriangleStarts[v + 1] += vertexTriangleStarts[v];
+    }
+
+    vertexTriangles.resize(corners.size());
+    std::vector<uint32_t> fill(vertexTriangleStarts.begin(), vertexTriangleStarts.end() - 1);
+    for (size_t i = 0; i < corners.size(); i++) {
+        vertexTriangles[fill[corners[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+}
+
+// Lists stay sorted by triangle, so the edited triangles of a vertex are one
+// run in its list. While no vertex gains or loses corners, each run keeps its
+// length and is rewritten in place.
+bool MeshTopology::patchIncidence(const std::vector<uint32_t> &previous, size_t firstTriangle) {
+    if (vertexTriangleStarts.size() != weldedVertices.size() + 1) {
+        return false;
+    }
+
+    // (vertex, triangle) for the new corners; the old ones only count down.
+    std::vector<std::pair<uint32_t, uint32_t>> added;
+    added.reserve(previous.size());
+    std::unordered_map<uint32_t, int32_t> balance;
+    for (size_t i = 0; i < previous.size(); i++) {
+        uint32_t vertex = corners[firstTriangle * 3 + i];
+        added.emplace_back(vertex, static_cast<uint32_t>(firstTriangle + i / 3));
+        balance[vertex]++;
+        balance[previous[i]]--;
+    }
+
+    for (const auto &entry : balance) {
+        if (entry.second != 0) {
+            return false;
+        }
+    }
+
+    std::sort(added.begin(), added.end());
+    for (size_t i = 0; i < added.size();) {
+        uint32_t vertex = added[i].first;
+        auto list = vertexTriangles.begin() + vertexTriangleStarts[vertex];
+        auto run = std::lower_bound(list, vertexTriangles.begin() + vertexTriangleStarts[vertex + 1],
+                                    static_cast<uint32_t>(firstTriangle));
+        for (; i < added.size() && added[i].first == vertex; i++) {
+            *run++ = added[i].second;
+        }
+    }
+
+    return true;
+}
+
+void MeshTopology::restore() {
+    m_OpenEdges.clear();
+
+    for (size_t halfEdge = 0; halfEdge < neighbors.size(); halfEdge++) {
+        uint64_t key;
+        if (neighbors[halfEdge] == c_NoNeighbor && weldedEdge(static_cast<uint32_t>(halfEdge), key)) {
+            m_OpenEdges.emplace(key, static_cast<uint32_t>(halfEdge));
+        }
+    }
+}
+
+void MeshTopology::clear() {
+    weldedVertices.clear();
+    corners.clear();
+    neighbors.clear();
+    neighborEdges.clear();
+    boundaryMask.clear();
+    vertexTriangleStarts.clear();
+    vertexTriangles.clear();
+    m_OpenEdges.clear();
+    weldedVertexCount = 0;
+}
+
+size_t MeshTopology::memoryUsage() const {
+    return weldedVertices.capacity() * sizeof(uint32_t) + corners.capacity() * sizeof(uint32_t) +
+           neighbors.capacity() * sizeof(int32_t) + neighborEdges.capacity() * sizeof(uint8_t) +
+           boundaryMask.capacity() * sizeof(uint8_t) + vertexTriangleStarts.capacity() * sizeof(uint32_t) +
+           vertexTriangles.capacity() * sizeof(uint32_t) +
+           m_OpenEdges.size() * (sizeof(uint64_t) + sizeof(uint32_t) + sizeof(void *)) +
+           m_OpenEdges.bucket_count() * sizeof(void *);
+}
+
+} // namespace Engine
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Vertex.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Connectivity of a triangle mesh. Works the same way for indexed meshes and
+ * triangle soups: vertices with equal positions are welded into one id, and
+ * every triangle knows its neighbour across each of its three edges.
+ *
+ * Edge k of a triangle goes from corner k to corner (k + 1) % 3.
+ *
+ * Welding happens in build() only: moving vertices afterwards keeps the
+ * connectivity, as expected of a deforming mesh.
+ */
+class MeshTopology {
+  public:
+    static constexpr int32_t c_NoNeighbor = -1;
+
+    std::vector<uint32_t> weldedVertices;
+    std::vector<uint32_t> corners;
+    std::vector<int32_t> neighbors;
+    std::vector<uint8_t> neighborEdges;
+    std::vector<uint8_t> boundaryMask;
+
+    // Triangles using vertex v are vertexTriangles[vertexTriangleStarts[v]] up to vertexTriangleStarts[v + 1].
+    std::vector<uint32_t> vertexTriangleStarts;
+    std::vector<uint32_t> vertexTriangles;
+
+    size_t weldedVertexCount = 0;
+
+    void build(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices);
+
+    /**
+     * Re-reads the corners of count triangles from firstTriangle on and
+     * relinks only their edges. The incidence lists of the vertices involved
+     * are patched in place, and rebuilt only when a vertex gains or loses
+     * triangles. The vertex and triangle counts must be the ones of the last
+     * build().
+     */
+    void update(const std::vector<unsigned int> &indices, size_t firstTriangle, size_t count);
+
+    /**
+     * Call after filling the public arrays directly, e.g. from a cache, to
+     * collect the open edges update() pairs new neighbours from.
+     */
+    void restore();
+    void clear();
+
+    bool empty() const { return corners.empty(); }
+    size_t triangleCount() const { return corners.size() / 3; }
+
+    uint32_t corner(size_t triangle, int k) const { return corners[triangle * 3 + k]; }
+    int32_t neighbor(size_t triangle, int edge) const { return neighbors[triangle * 3 + edge]; }
+    int neighborEdge(size_t triangle, int edge) const { return neighborEdges[triangle * 3 + edge]; }
+    bool isBoundary(size_t triangle, int edge) const { return (boundaryMask[triangle] >> edge) & 1u; }
+
+    size_t memoryUsage() const;
+
+  private:
+    // Welded edge -> the one half-edge on it still waiting for a partner
+    std::unordered_map<uint64_t, uint32_t> m_OpenEdges;
+
+    // False for edges collapsed onto one welded vertex, which never link.
+    bool weldedEdge(uint32_t halfEdge, uint64_t &key) const;
+    void link(uint32_t halfEdge);
+    void unlink(uint32_t halfEdge);
+    void buildIncidence();
+    // Swaps the edited triangles into the incidence lists; false when a vertex's triangle count changed.
+    bool patchIncidence(const std::vector<uint32_t> &previous, size_t firstTriangle);
+};
+
+} // namespace Engine
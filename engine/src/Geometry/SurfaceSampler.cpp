@@ -0,0 +1,59 @@
+#include "SurfaceSampler.hpp"
+
+#include <cmath>
+
+namespace Engine {
+
+void SurfaceSampler::build(const TriangleFrames &frames) {
+    size_t count = frames.size();
+    entries.assign(count, Entry{1.0f, 0});
+
+    double totalArea = 0.0;
+    for (const auto &frame : frames.frames) {
+        totalArea += frame.area;
+    }
+
+    if (count == 0 || totalArea <= 0.0) {
+        for (size_t i = 0; i < count; i++) {
+            entries[i].alias = static_cast<uint32_t>(i);
+        }
+        return;
+    }
+
+    // Vose's variant: scaled areas below 1 are topped up by one donor above 1.
+    std::vector<double> scaled(count);
+    std::vector<uint32_t> small, large;
+    for (size_t i = 0; i < count; i++) {
+        scaled[i] = frames[i].area * static_cast<double>(count) / totalArea;
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+
+    while (!small.empty() && !large.empty()) {
+        uint32_t less = small.back();
+        uint32_t more = large.back();
+        small.pop_back();
+
+        entries[less] = Entry{static_cast<float>(scaled[less]), more};
+        scaled[more] -= 1.0 - scaled[less];
+
+        if (scaled[more] < 1.0) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+
+    // Whatever is left is 1 up to rounding.
+    for (uint32_t i : small) {
+        entries[i] = Entry{1.0f, i};
+    }
+    for (uint32_t i : large) {
+        entries[i] = Entry{1.0f, i};
+    }
+}
+
+glm::vec3 SurfaceSampler::barycentric(float u, float v) {
+    float r = std::sqrt(u);
+    return glm::vec3(1.0f - r, r * (1.0f - v), r * v);
+}
+
+} // namespace Engine
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "TriangleFrames.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Picks triangles with probability proportional to their area in O(1) using
+ * Walker's alias method, and points uniformly inside a triangle.
+ */
+class SurfaceSampler {
+  public:
+    struct Entry {
+        float probability;
+        uint32_t alias;
+    };
+
+    std::vector<Entry> entries;
+
+    void build(const TriangleFrames &frames);
+    void clear() { entries.clear(); }
+
+    bool empty() const { return entries.empty(); }
+    size_t size() const { return entries.size(); }
+
+    // column is uniform in [0, size()), coin uniform in [0, 1)
+    uint32_t sample(uint32_t column, float coin) const {
+        const Entry &entry = entries[column];
+        return coin < entry.probability ? column : entry.alias;
+    }
+
+    size_t memoryUsage() const { return entries.capacity() * sizeof(Entry); }
+
+    // Barycentric weights of a uniform point for u, v uniform in [0, 1)
+    static glm::vec3 barycentric(float u, float v);
+};
+
+} // namespace Engine
@@ -0,0 +1,117 @@
+#include "TriangleFrames.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+
+namespace Engine {
+
+void TriangleFrames::build(const std::vector<Vertex> &vertices, const MeshTopology &topology) {
+    size_t triangles = topology.triangleCount();
+    frames.resize(triangles);
+    bases.resize(triangles);
+
+    for (size_t triangle = 0; triangle < triangles; triangle++) {
+        buildTriangle(vertices, topology, triangle);
+    }
+
+    restore(vertices);
+}
+
+size_t TriangleFrames::update(const std::vector<Vertex> &vertices, const MeshTopology &topology) {
+    MeshChange change;
+    change.reset(topology.triangleCount());
+    return update(vertices, topology, 0, vertices.size(), change);
+}
+
+size_t TriangleFrames::update(const std::vector<Vertex> &vertices, const MeshTopology &topology, size_t firstVertex,
+                              size_t vertexCount, MeshChange &change) {
+    if (vertices.size() != m_Positions.size() || frames.size() != topology.triangleCount()) {
+        build(vertices, topology);
+        return frames.size();
+    }
+
+    size_t end = std::min(firstVertex + vertexCount, vertices.size());
+
+    // Collect before touching the snapshot: previous corners are read from it.
+    for (size_t v = firstVertex; v < end; v++) {
+        if (vertices[v].position == m_Positions[v]) {
+            continue;
+        }
+
+        for (uint32_t i = topology.vertexTriangleStarts[v]; i < topology.vertexTriangleStarts[v + 1]; i++) {
+            uint32_t triangle = topology.vertexTriangles[i];
+            if (!change.contains(triangle)) {
+                change.add(triangle, m_Positions[topology.corner(triangle, 0)],
+                           m_Positions[topology.corner(triangle, 1)], m_Positions[topology.corner(triangle, 2)]);
+            }
+        }
+    }
+
+    for (size_t v = firstVertex; v < end; v++) {
+        m_Positions[v] = vertices[v].position;
+    }
+
+    for (uint32_t triangle : change.triangles) {
+        buildTriangle(vertices, topology, triangle);
+    }
+
+    return change.triangles.size();
+}
+
+void TriangleFrames::restore(const std::vector<Vertex> &vertices) {
+    m_Positions.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        m_Positions[i] = vertices[i].position;
+    }
+}
+
+void TriangleFrames::clear() {
+    frames.clear();
+    bases.clear();
+    m_Positions.clear();
+}
+
+size_t TriangleFrames::memoryUsage() const {
+    return frames.capacity() * sizeof(TriangleFrame) + bases.capacity() * sizeof(TriangleBasis) +
+           m_Positions.capacity() * sizeof(glm::vec3);
+}
+
+void TriangleFrames::buildTriangle(const std::vector<Vertex> &vertices, const MeshTopology &topology,
+                                   size_t triangle) {
+    frames[triangle] = createFrame(vertices[topology.corner(triangle, 0)].position,
+                                   vertices[topology.corner(triangle, 1)].position,
+                                   vertices[topology.corner(triangle, 2)].position);
+    bases[triangle] = createBasis(frames[triangle]);
+}
+
+TriangleFrame TriangleFrames::createFrame(glm::vec3 P0, glm::vec3 P1, glm::vec3 P2) {
+    const glm::vec3 corners[3] = {P0, P1, P2};
+
+    TriangleFrame frame;
+    glm::vec3 cross = glm::cross(P1 - P0, P2 - P0);
+    float doubleArea = glm::length(cross);
+
+    frame.area = doubleArea * 0.5f;
+    frame.normal = doubleArea > 0.0f ? cross / doubleArea : glm::vec3(0.0f);
+
+    for (int edge = 0; edge < 3; edge++) {
+        glm::vec3 edgeVec = corners[(edge + 1) % 3] - corners[edge];
+        float edgeLength = glm::length(edgeVec);
+        glm::vec3 edgeDir = edgeLength > 0.0f ? edgeVec / edgeLength : glm::vec3(0.0f);
+
+        frame.edgeNormals[edge] = glm::cross(frame.normal, edgeDir);
+        frame.edgeOffsets[edge] = glm::dot(frame.edgeNormals[edge], corners[edge]);
+    }
+
+    return frame;
+}
+
+TriangleBasis TriangleFrames::createBasis(const TriangleFrame &frame) {
+    TriangleBasis basis;
+    basis.tangent = glm::cross(frame.edgeNormals[0], frame.normal);
+    basis.bitangent = glm::cross(frame.normal, basis.tangent);
+    return basis;
+}
+
+} // namespace Engine
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "MeshChange.hpp"
+#include "MeshTopology.hpp"
+#include "Vertex.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Per-triangle data that is constant while the mesh does not move.
+ *
+ * Edge planes are perpendicular to the triangle and contain its edges; their
+ * normals point inside the triangle, so a point P on the triangle plane is
+ * inside the triangle when dot(edgeNormals[k], P) >= edgeOffsets[k] for all k.
+ */
+struct TriangleFrame {
+    glm::vec3 normal;
+    glm::vec3 edgeNormals[3];
+    float edgeOffsets[3];
+    float area;
+};
+
+/**
+ * Orthonormal tangent basis of a triangle: tangent runs along edge 0 and
+ * bitangent = cross(normal, tangent).
+ */
+struct TriangleBasis {
+    glm::vec3 tangent;
+    glm::vec3 bitangent;
+};
+
+class TriangleFrames {
+  public:
+    // Kept apart from the frames: the walker kernels read TriangleFrame as a fixed 64 byte record
+    // and never need the basis.
+    std::vector<TriangleFrame> frames;
+    std::vector<TriangleBasis> bases;
+
+    void build(const std::vector<Vertex> &vertices, const MeshTopology &topology);
+
+    /**
+     * Rebuilds only the triangles touching vertices whose position changed
+     * since the last build or update. Returns the number of triangles rebuilt.
+     */
+    size_t update(const std::vector<Vertex> &vertices, const MeshTopology &topology);
+
+    /**
+     * Same for the vertices in [firstVertex, firstVertex + vertexCount) only,
+     * so the cost follows the size of the edit. Touched triangles are added
+     * to change with their previous corners, and every triangle listed in
+     * change, including ones added before the call, is rebuilt.
+     */
+    size_t update(const std::vector<Vertex> &vertices, const MeshTopology &topology, size_t firstVertex,
+                  size_t vertexCount, MeshChange &change);
+
+    /**
+     * Call after filling frames and bases directly, e.g. from a cache, so
+     * that update() takes the current vertices as the built ones.
+     */
+    void restore(const std::vector<Vertex> &vertices);
+    void clear();
+
+    bool empty() const { return frames.empty(); }
+    size_t size() const { return frames.size(); }
+
+    const TriangleFrame &operator[](size_t triangle) const { return frames[triangle]; }
+
+    const TriangleBasis &basis(size_t triangle) const { return bases[triangle]; }
+
+    // Position of a vertex as of the last build or update
+    glm::vec3 lastPosition(uint32_t vertex) const { return m_Positions[vertex]; }
+
+    size_t memoryUsage() const;
+
+    static TriangleFrame createFrame(glm::vec3 P0, glm::vec3 P1, glm::vec3 P2);
+    static TriangleBasis createBasis(const TriangleFrame &frame);
+
+  private:
+    std::vector<glm::vec3> m_Positions;
+
+    void buildTriangle(const std::vector<Vertex> &vertices, const MeshTopology &topology, size_t triangle);
+};
+
+} // namespace Engine
@@ -0,0 +1,65 @@
+#include "VertexIndexer.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace Engine {
+
+namespace {
+
+const uint32_t c_FreeSlot = UINT32_MAX;
+
+uint64_t vertexHash(const Vertex &vertex) {
+    // Position, normal and texture coordinate are the first 8 floats.
+    uint32_t words[8];
+    std::memcpy(words, &vertex, sizeof(words));
+
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (uint32_t word : words) {
+        hash = (hash ^ word) * 0x100000001B3ull;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+} // namespace
+
+VertexIndexer::Stats VertexIndexer::index(const std::vector<Vertex> &soup, std::vector<Vertex> &vertices,
+                                          std::vector<unsigned int> &indices) {
+    vertices.clear();
+    indices.resize(soup.size());
+
+    // Open addressing at no more than half load; slots hold output vertex indices.
+    size_t capacity = 16;
+    while (capacity < soup.size() * 2) {
+        capacity *= 2;
+    }
+    std::vector<uint32_t> slots(capacity, c_FreeSlot);
+    size_t mask = capacity - 1;
+
+    for (size_t i = 0; i < soup.size(); i++) {
+        const Vertex &vertex = soup[i];
+        size_t slot = static_cast<size_t>(vertexHash(vertex)) & mask;
+
+        while (slots[slot] != c_FreeSlot && std::memcmp(&vertices[slots[slot]], &vertex, sizeof(Vertex)) != 0) {
+            slot = (slot + 1) & mask;
+        }
+
+        if (slots[slot] == c_FreeSlot) {
+            slots[slot] = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(vertex);
+        }
+        indices[i] = slots[slot];
+    }
+    vertices.shrink_to_fit();
+
+    Stats stats;
+    stats.soupVertices = soup.size();
+    stats.vertices = vertices.size();
+    stats.indexBytes = indexBytes(vertices.size());
+    stats.soupBytes = soup.size() * sizeof(Vertex);
+    stats.indexedBytes = vertices.size() * sizeof(Vertex) + indices.size() * stats.indexBytes;
+    return stats;
+}
+
+} // namespace Engine
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Vertex.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Turns a triangle soup into an indexed mesh by merging bitwise identical
+ * vertices. Candidates are found by hashing position, normal and texture
+ * coordinate, then the whole vertex is compared, so vertices differing in
+ * any attribute stay apart.
+ */
+class VertexIndexer {
+  public:
+    struct Stats {
+        size_t soupVertices = 0;
+        size_t vertices = 0;
+
+        // Width the GPU index buffer will use, see indexBytes()
+        size_t indexBytes = 4;
+
+        size_t soupBytes = 0;
+        size_t indexedBytes = 0;
+
+        size_t savedBytes() const { return soupBytes > indexedBytes ? soupBytes - indexedBytes : 0; }
+    };
+
+    /**
+     * Writes the unique vertices of soup in first-use order to vertices and
+     * one index per soup vertex to indices.
+     */
+    static Stats index(const std::vector<Vertex> &soup, std::vector<Vertex> &vertices,
+                       std::vector<unsigned int> &indices);
+
+    // 16-bit indices while every vertex can be addressed with them, 32-bit otherwise.
+    static size_t indexBytes(size_t vertexCount) { return vertexCount <= 0x10000 ? 2 : 4; }
+};
+
+} // namespace Engine
@@ -0,0 +1,208 @@
+#include "BarycentricParticleSystem.hpp"
+
+#include "BarycentricStepper.hpp"
+#include "Math.hpp"
+#include "Random.hpp"
+#include "SurfaceSampler.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+BarycentricParticleSystem::BarycentricParticleSystem(Mesh &surface)
+    : m_Surface(surface), m_Seed(Math::getSeed()) {
+    if (m_Surface.topology.empty()) {
+        m_Surface.buildTopology();
+    }
+    if (m_Surface.frames.empty()) {
+        m_Surface.buildFrames();
+    }
+    if (m_Surface.sampler.empty()) {
+        m_Surface.buildSampler();
+    }
+    if (m_Surface.positions.empty()) {
+        m_Surface.buildPositions();
+    }
+
+    m_SurfaceListener = m_Surface.addChangeListener([this](const MeshChange &change) { onSurfaceChanged(change); });
+}
+
+BarycentricParticleSystem::~BarycentricParticleSystem() { m_Surface.removeChangeListener(m_SurfaceListener); }
+
+size_t BarycentricParticleSystem::grow(size_t count) {
+    size_t offset = size();
+    m_Coordinates.resize(offset + count);
+    m_Directions.resize(offset + count);
+    m_Speeds.resize(offset + count, m_Speed);
+    m_Triangles.resize(offset + count);
+    m_TriangleIndex.invalidate();
+    return offset;
+}
+
+void BarycentricParticleSystem::spawn(size_t count) {
+    m_Surface.updateSampler();
+    if (m_Surface.sampler.empty()) {
+        return;
+    }
+
+    size_t offset = grow(count);
+    spawnRange(offset, offset + count);
+}
+
+void BarycentricParticleSystem::spawn(size_t count, JobPool &jobs) {
+    m_Surface.updateSampler();
+    if (m_Surface.sampler.empty()) {
+        return;
+    }
+
+    size_t offset = grow(count);
+    jobs.parallelFor(count, m_ChunkSize,
+                     [this, offset](size_t begin, size_t end, unsigned) { spawnRange(offset + begin, offset + end); });
+}
+
+void BarycentricParticleSystem::spawnRange(size_t begin, size_t end) {
+    const SurfaceSampler &sampler = m_Surface.sampler;
+    uint32_t triangles = static_cast<uint32_t>(sampler.size());
+
+    // Same draws as SurfaceParticleSystem, so both systems start from the same state for a given seed.
+    for (size_t i = begin; i < end; i++) {
+        Random random(m_Seed, i);
+
+        uint32_t column = random.nextBelow(triangles);
+        uint32_t triangle = sampler.sample(column, random.nextFloat());
+
+        glm::vec3 weights = SurfaceSampler::barycentric(random.nextFloat(), random.nextFloat());
+
+        const TriangleBasis &basis = m_Surface.frames.basis(triangle);
+        glm::vec3 T = basis.tangent;
+        glm::vec3 B = basis.bitangent;
+        float angle = random.nextFloat() * 2.0f * Math::c_Pi;
+        glm::vec3 direction = T * std::cos(angle) + B * std::sin(angle);
+
+        m_Coordinates[i] = glm::vec2(weights.y, weights.z);
+        m_Directions[i] = BarycentricStepper::fromDirection(m_Surface, triangle, direction);
+        m_Triangles[i] = triangle;
+    }
+}
+
+void BarycentricParticleSystem::clear() {
+    m_Coordinates.clear();
+    m_Directions.clear();
+    m_Speeds.clear();
+    m_Triangles.clear();
+    m_TriangleIndex.invalidate();
+}
+
+void BarycentricParticleSystem::update(float deltaSeconds) {
+    if (m_Stats.empty()) {
+        m_Stats.resize(1);
+    }
+    m_TriangleIndex.invalidate();
+
+    updateRange(0, size(), deltaSeconds, m_Stats[0]);
+}
+
+void BarycentricParticleSystem::update(float deltaSeconds, JobPool &jobs) {
+    if (m_Stats.size() < jobs.getSlotCount()) {
+        m_Stats.resize(jobs.getSlotCount());
+    }
+    m_TriangleIndex.invalidate();
+
+    jobs.parallelFor(size(), m_ChunkSize, [this, deltaSeconds](size_t begin, size_t end, unsigned worker) {
+        updateRange(begin, end, deltaSeconds, m_Stats[worker]);
+    });
+}
+
+void BarycentricParticleSystem::updateRange(size_t begin, size_t end, float deltaSeconds, Stats &stats) {
+    for (size_t i = begin; i < end; i++) {
+        auto result = BarycentricStepper::step(m_Surface, m_Coordinates[i], m_Directions[i], m_Triangles[i],
+                                               m_Speeds[i] * deltaSeconds);
+        stats.crossings += result.crossings;
+        stats.bounces += result.bounces;
+    }
+}
+
+void BarycentricParticleSystem::onSurfaceChanged(const MeshChange &change) {
+    if (change.rebuilt) {
+        size_t count = size();
+        clear();
+        spawn(count);
+        return;
+    }
+
+    // Positions follow the corners by themselves; directions are rates per
+    // unit of distance and have to be scaled back to unit speed.
+    if (!m_TriangleIndex.prepare(m_Triangles, m_Surface.topology.triangleCount())) {
+        for (size_t i = 0; i < size(); i++) {
+            if (change.contains(m_Triangles[i])) {
+                renormalize(i);
+            }
+        }
+        return;
+    }
+
+    for (uint32_t triangle : change.triangles) {
+        m_TriangleIndex.forEachOn(triangle, [this](uint32_t i) { renormalize(i); });
+    }
+}
+
+void BarycentricParticleSystem::renormalize(size_t index) {
+    uint32_t triangle = m_Triangles[index];
+    glm::vec3 direction = BarycentricStepper::toDirection(m_Surface, triangle, m_Directions[index]);
+    float length = glm::length(direction);
+    if (length > 0.0f) {
+        m_Directions[index] = BarycentricStepper::fromDirection(m_Surface, triangle, direction / length);
+    }
+}
+
+glm::vec3 BarycentricParticleSystem::getPosition(size_t index) const {
+    return BarycentricStepper::toPosition(m_Surface, m_Triangles[index], m_Coordinates[index]);
+}
+
+glm::vec3 BarycentricParticleSystem::getDirection(size_t index) const {
+    return BarycentricStepper::toDirection(m_Surface, m_Triangles[index], m_Directions[index]);
+}
+
+void BarycentricParticleSystem::writeTransforms(float *rows) const {
+    for (size_t i = 0; i < size(); i++) {
+        glm::vec3 N = m_Surface.frames[m_Triangles[i]].normal;
+        glm::vec3 forward = glm::normalize(getDirection(i));
+        glm::vec3 right = glm::cross(forward, N);
+        glm::vec3 P = getPosition(i);
+
+        float *row = rows + i * 12;
+        for (int r = 0; r < 3; r++) {
+            row[r * 4 + 0] = right[r];
+            row[r * 4 + 1] = N[r];
+            row[r * 4 + 2] = -forward[r];
+            row[r * 4 + 3] = P[r];
+        }
+    }
+}
+
+BarycentricParticleSystem::Stats BarycentricParticleSystem::getStats() const {
+    Stats total;
+    for (const auto &stats : m_Stats) {
+        total.crossings += stats.crossings;
+        total.bounces += stats.bounces;
+    }
+    return total;
+}
+
+size_t BarycentricParticleSystem::memoryUsage() const {
+    return (m_Coordinates.capacity() + m_Directions.capacity()) * sizeof(glm::vec2) +
+           m_Speeds.capacity() * sizeof(float) + m_Triangles.capacity() * sizeof(uint32_t) +
+           m_TriangleIndex.memoryUsage();
+}
+
+float BarycentricParticleSystem::bytesPerParticle() const {
+    if (size() == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(memoryUsage()) / static_cast<float>(size());
+}
+
+} // namespace Engine
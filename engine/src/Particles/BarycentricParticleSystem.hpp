@@ -0,0 +1,102 @@
+#pragma once
+
+#include "JobPool.hpp"
+#include "Mesh.hpp"
+#include "SurfaceStepper.hpp"
+#include "TriangleParticleIndex.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Surface particles stored as triangle index, barycentric (u, v) and a
+ * direction in barycentric rates instead of world-space vectors. Particles
+ * stay exactly on their triangle no matter how long they walk; world
+ * positions are only built by writeTransforms() for rendering.
+ */
+class BarycentricParticleSystem {
+  public:
+    struct Stats {
+        size_t crossings = 0;
+        size_t bounces = 0;
+    };
+
+  private:
+    Mesh &m_Surface;
+    size_t m_SurfaceListener;
+
+    std::vector<glm::vec2> m_Coordinates;
+    std::vector<glm::vec2> m_Directions;
+    std::vector<float> m_Speeds;
+    std::vector<uint32_t> m_Triangles;
+    TriangleParticleIndex m_TriangleIndex;
+
+    float m_Speed = 0.3f;
+    size_t m_ChunkSize = 16384;
+    uint64_t m_Seed;
+
+    // One entry per job pool slot, so chunks never write the same counters.
+    std::vector<Stats> m_Stats;
+
+  public:
+    // Particles follow committed surface edits by their barycentric location; a rebuilt surface respawns them.
+    explicit BarycentricParticleSystem(Mesh &surface);
+    ~BarycentricParticleSystem();
+
+    BarycentricParticleSystem(const BarycentricParticleSystem &) = delete;
+    BarycentricParticleSystem &operator=(const BarycentricParticleSystem &) = delete;
+
+    void spawn(size_t count);
+    void spawn(size_t count, JobPool &jobs);
+    void clear();
+
+    void update(float deltaSeconds);
+    void update(float deltaSeconds, JobPool &jobs);
+
+    glm::vec3 getPosition(size_t index) const;
+    glm::vec3 getDirection(size_t index) const;
+
+    // Packed 3x4 row-major transforms, 12 floats per particle, as Mesh::setInstances expects
+    void writeTransforms(float *rows) const;
+
+    // Sets the speed of every current particle and of later spawns.
+    void setSpeed(float speed) {
+        m_Speed = speed;
+        std::fill(m_Speeds.begin(), m_Speeds.end(), speed);
+    }
+    float getSpeed() const { return m_Speed; }
+
+    void setSeed(uint64_t seed) { m_Seed = seed; }
+    uint64_t getSeed() const { return m_Seed; }
+
+    void setChunkSize(size_t chunkSize) { m_ChunkSize = chunkSize; }
+    size_t getChunkSize() const { return m_ChunkSize; }
+
+    size_t size() const { return m_Triangles.size(); }
+    size_t memoryUsage() const;
+    float bytesPerParticle() const;
+
+    Stats getStats() const;
+    void resetStats() { m_Stats.assign(m_Stats.size(), Stats()); }
+
+    const Mesh &getSurface() const { return m_Surface; }
+    const std::vector<glm::vec2> &getCoordinates() const { return m_Coordinates; }
+    const std::vector<glm::vec2> &getDirections() const { return m_Directions; }
+    const std::vector<uint32_t> &getTriangles() const { return m_Triangles; }
+
+  private:
+    size_t grow(size_t count);
+    void spawnRange(size_t begin, size_t end);
+    void updateRange(size_t begin, size_t end, float deltaSeconds, Stats &stats);
+    void onSurfaceChanged(const MeshChange &change);
+    void renormalize(size_t index);
+};
+
+} // namespace Engine
@@ -0,0 +1,107 @@
+#include "BarycentricStepper.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+
+namespace Engine {
+
+namespace {
+
+glm::vec3 corner(const Mesh &surface, uint32_t triangle, int k) { return surface.cornerPosition(triangle, k); }
+
+// Gradient of the weight of corner k: the inward normal of the opposite
+// edge divided by the height of the triangle over that edge.
+glm::vec3 weightGradient(const Mesh &surface, uint32_t triangle, int k) {
+    const TriangleFrame &frame = surface.frames[triangle];
+    int edge = (k + 1) % 3;
+
+    float height = glm::dot(frame.edgeNormals[edge], corner(surface, triangle, k)) - frame.edgeOffsets[edge];
+    return height > 0.0f ? frame.edgeNormals[edge] / height : glm::vec3(0.0f);
+}
+
+} // namespace
+
+SurfaceStepper::Result BarycentricStepper::step(const Mesh &surface, glm::vec2 &uv, glm::vec2 &direction,
+                                                uint32_t &triangle, float distance) {
+    SurfaceStepper::Result result;
+    float remaining = distance;
+
+    for (int i = 0; i < SurfaceStepper::c_MaxCrossings && remaining > 0.0f; i++) {
+        float weights[3] = {1.0f - uv.x - uv.y, uv.x, uv.y};
+        float rates[3] = {-direction.x - direction.y, direction.x, direction.y};
+
+        // Edge k runs from corner k to corner k + 1 and is reached when the
+        // weight of the opposite corner drops to zero.
+        float time = remaining;
+        int exitEdge = -1;
+        for (int edge = 0; edge < 3; edge++) {
+            int opposite = (edge + 2) % 3;
+            if (rates[opposite] >= 0.0f) {
+                continue;
+            }
+
+            float edgeTime = std::max(weights[opposite], 0.0f) / -rates[opposite];
+            if (edgeTime < time) {
+                time = edgeTime;
+                exitEdge = edge;
+            }
+        }
+
+        uv += direction * time;
+        remaining -= time;
+
+        if (exitEdge < 0) {
+            break;
+        }
+
+        // Snap onto the exit edge and read the position along it.
+        float along = std::clamp(exitEdge == 0 ? uv.x : (exitEdge == 1 ? uv.y : 1.0f - uv.x - uv.y), 0.0f, 1.0f);
+
+        int32_t next = surface.topology.neighbor(triangle, exitEdge);
+        if (next == MeshTopology::c_NoNeighbor) {
+            float snapped[3] = {0.0f, 0.0f, 0.0f};
+            snapped[(exitEdge + 1) % 3] = along;
+            snapped[exitEdge] = 1.0f - along;
+            uv = glm::vec2(snapped[1], snapped[2]);
+
+            direction *= -1.0f;
+            result.bounces++;
+            continue;
+        }
+
+        int nextEdge = surface.topology.neighborEdge(triangle, exitEdge);
+        glm::vec3 worldDirection = toDirection(surface, triangle, direction);
+        worldDirection = SurfaceStepper::unfold(surface.frames[triangle], exitEdge, surface.frames[next], nextEdge,
+                                                worldDirection);
+
+        // The shared edge runs the other way round in the neighbour.
+        float snapped[3] = {0.0f, 0.0f, 0.0f};
+        snapped[nextEdge] = along;
+        snapped[(nextEdge + 1) % 3] = 1.0f - along;
+
+        triangle = static_cast<uint32_t>(next);
+        uv = glm::vec2(snapped[1], snapped[2]);
+        direction = fromDirection(surface, triangle, worldDirection);
+        result.crossings++;
+    }
+
+    return result;
+}
+
+glm::vec3 BarycentricStepper::toPosition(const Mesh &surface, uint32_t triangle, glm::vec2 uv) {
+    glm::vec3 P0 = corner(surface, triangle, 0);
+    return P0 + (corner(surface, triangle, 1) - P0) * uv.x + (corner(surface, triangle, 2) - P0) * uv.y;
+}
+
+glm::vec3 BarycentricStepper::toDirection(const Mesh &surface, uint32_t triangle, glm::vec2 direction) {
+    glm::vec3 P0 = corner(surface, triangle, 0);
+    return (corner(surface, triangle, 1) - P0) * direction.x + (corner(surface, triangle, 2) - P0) * direction.y;
+}
+
+glm::vec2 BarycentricStepper::fromDirection(const Mesh &surface, uint32_t triangle, glm::vec3 direction) {
+    return glm::vec2(glm::dot(weightGradient(surface, triangle, 1), direction),
+                     glm::dot(weightGradient(surface, triangle, 2), direction));
+}
+
+} // namespace Engine
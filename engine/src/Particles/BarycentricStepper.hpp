@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Mesh.hpp"
+#include "SurfaceStepper.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+
+namespace Engine {
+
+/**
+ * Moves a point stored as (triangle, barycentric u, v) along a mesh surface.
+ * The point is P0 + u * (P1 - P0) + v * (P2 - P0) of its triangle and the
+ * direction (du, dv) is the rate of change of (u, v) per unit of distance, so
+ * the point can never leave the triangle plane and each edge test is a sign
+ * check on one barycentric weight.
+ */
+class BarycentricStepper {
+  public:
+    static SurfaceStepper::Result step(const Mesh &surface, glm::vec2 &uv, glm::vec2 &direction, uint32_t &triangle,
+                                       float distance);
+
+    // World position and unit direction of a barycentric state
+    static glm::vec3 toPosition(const Mesh &surface, uint32_t triangle, glm::vec2 uv);
+    static glm::vec3 toDirection(const Mesh &surface, uint32_t triangle, glm::vec2 direction);
+
+    // Barycentric rates of a world direction lying in the triangle plane
+    static glm::vec2 fromDirection(const Mesh &surface, uint32_t triangle, glm::vec3 direction);
+};
+
+} // namespace Engine
@@ -0,0 +1,134 @@
+#include "ParticleSnapshot.hpp"
+
+#include "AtomicFileWriter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+namespace Engine {
+
+namespace {
+
+const char c_Magic[8] = {'P', 'A', 'R', 'T', 'S', 'N', 'A', 'P'};
+const uint32_t c_ByteOrder = 0x01020304u;
+
+size_t alignUp(size_t offset) {
+    return (offset + ParticleSnapshot::c_Alignment - 1) & ~(ParticleSnapshot::c_Alignment - 1);
+}
+
+bool snapshotError(const std::string &path, const char *reason) {
+    std::cerr << "ParticleSnapshot: " << path << ": " << reason << "\n";
+    return false;
+}
+
+} // namespace
+
+ParticleSnapshot::Header ParticleSnapshot::createHeader(size_t particleCount, size_t arrayCount) {
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, c_Magic, sizeof(c_Magic));
+    header.version = c_Version;
+    header.byteOrder = c_ByteOrder;
+    header.headerBytes = sizeof(Header);
+    header.arrayCount = static_cast<uint32_t>(std::min(arrayCount, c_MaxArrays));
+    header.particleCount = particleCount;
+
+    size_t offset = alignUp(sizeof(Header));
+    for (uint32_t i = 0; i < header.arrayCount; i++) {
+        header.arrayOffsets[i] = offset;
+        offset = alignUp(offset + particleCount * c_ElementBytes);
+    }
+
+    return header;
+}
+
+bool ParticleSnapshot::write(const std::string &path, const Header &header, const std::vector<const void *> &arrays) {
+    if (arrays.size() != header.arrayCount) {
+        return snapshotError(path, "array count does not match the header");
+    }
+
+    AtomicFileWriter out;
+    if (!out.open(path)) {
+        return snapshotError(path, "cannot create a temporary file next to it");
+    }
+
+    size_t offset = sizeof(Header);
+    out.write(&header, sizeof(Header));
+
+    for (size_t i = 0; i < arrays.size(); i++) {
+        out.writeZeros(header.arrayOffsets[i] - offset);
+        size_t bytes = header.particleCount * c_ElementBytes;
+        out.write(arrays[i], bytes);
+        offset = header.arrayOffsets[i] + bytes;
+    }
+
+    if (!out.commit()) {
+        return snapshotError(path, "write failed");
+    }
+    return true;
+}
+
+std::future<bool> ParticleSnapshot::writeAsync(const std::string &path, const Header &header,
+                                               const std::vector<const void *> &arrays) {
+    auto copies = std::make_shared<std::vector<std::vector<uint32_t>>>(arrays.size());
+    for (size_t i = 0; i < arrays.size(); i++) {
+        const uint32_t *values = static_cast<const uint32_t *>(arrays[i]);
+        (*copies)[i].assign(values, values + header.particleCount);
+    }
+
+    return std::async(std::launch::async, [path, header, copies]() {
+        std::vector<const void *> pointers;
+        for (const auto &copy : *copies) {
+            pointers.push_back(copy.data());
+        }
+        return write(path, header, pointers);
+    });
+}
+
+bool ParticleSnapshot::open(const std::string &path) {
+    close();
+
+    if (!m_File.open(path)) {
+        return snapshotError(path, "cannot open");
+    }
+    if (m_File.size() < sizeof(Header)) {
+        close();
+        return snapshotError(path, "too small for a snapshot header");
+    }
+
+    // Mappings start on a page boundary, so the header can be read in place.
+    const Header *header = reinterpret_cast<const Header *>(m_File.data());
+    if (std::memcmp(header->magic, c_Magic, sizeof(c_Magic)) != 0) {
+        close();
+        return snapshotError(path, "not a particle snapshot");
+    }
+    if (header->version != c_Version || header->byteOrder != c_ByteOrder || header->headerBytes != sizeof(Header)) {
+        close();
+        return snapshotError(path, "unsupported snapshot version or byte order");
+    }
+    if (header->arrayCount > c_MaxArrays || header->particleCount > m_File.size() / c_ElementBytes) {
+        close();
+        return snapshotError(path, "corrupt array table");
+    }
+
+    size_t bytes = header->particleCount * c_ElementBytes;
+    for (uint32_t i = 0; i < header->arrayCount; i++) {
+        uint64_t offset = header->arrayOffsets[i];
+        if (offset % c_Alignment != 0 || offset > m_File.size() || m_File.size() - offset < bytes) {
+            close();
+            return snapshotError(path, "array out of bounds, file is truncated");
+        }
+    }
+
+    m_Header = header;
+    return true;
+}
+
+void ParticleSnapshot::close() {
+    m_Header = nullptr;
+    m_File.close();
+}
+
+} // namespace Engine
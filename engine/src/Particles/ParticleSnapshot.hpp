@@ -0,0 +1,83 @@
+#pragma once
+
+#include "MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Versioned binary checkpoint of a particle population. The file is a fixed
+ * header followed by the raw particle arrays, each starting on a 64 byte
+ * boundary, in host byte order. Every array element is 4 bytes wide.
+ *
+ * Reading maps the file and hands out pointers straight into the mapping, so
+ * restoring is one bulk copy per array with nothing parsed in between.
+ */
+class ParticleSnapshot {
+  public:
+    static constexpr uint32_t c_Version = 1;
+    static constexpr size_t c_Alignment = 64;
+    static constexpr size_t c_ElementBytes = 4;
+    static constexpr size_t c_MaxArrays = 16;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t headerBytes;
+        uint32_t arrayCount;
+
+        uint64_t particleCount;
+        // Spawn streams are keyed by (seed, particle index), so the seed is all the RNG state there is.
+        uint64_t seed;
+        uint64_t stepsSinceSort;
+
+        // The surface the particles walk on, checked on restore
+        uint64_t surfaceVertices;
+        uint64_t surfaceTriangles;
+
+        float speed;
+        uint32_t reserved;
+
+        uint64_t arrayOffsets[c_MaxArrays];
+    };
+
+  private:
+    MappedFile m_File;
+    const Header *m_Header = nullptr;
+
+  public:
+    static Header createHeader(size_t particleCount, size_t arrayCount);
+
+    /**
+     * Writes through an AtomicFileWriter, so a crash or a concurrent save
+     * never leaves a torn snapshot behind.
+     */
+    static bool write(const std::string &path, const Header &header, const std::vector<const void *> &arrays);
+
+    /**
+     * Copies the arrays right away and writes them on a background thread,
+     * so the caller can keep changing the particles.
+     */
+    static std::future<bool> writeAsync(const std::string &path, const Header &header,
+                                        const std::vector<const void *> &arrays);
+
+    // Maps the file and validates the header and array extents.
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return m_Header != nullptr; }
+    const Header &getHeader() const { return *m_Header; }
+    size_t size() const { return m_Header->particleCount; }
+
+    const void *array(size_t index) const { return m_File.data() + m_Header->arrayOffsets[index]; }
+
+    void adviseSequential() const { m_File.adviseSequential(); }
+};
+
+} // namespace Engine
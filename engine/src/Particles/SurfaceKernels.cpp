@@ -0,0 +1,390 @@
+#include "SurfaceKernels.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ENGINE_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define ENGINE_SIMD_X86 0
+#endif
+
+namespace Engine {
+
+namespace {
+
+// Kernels address TriangleFrame as 16 consecutive floats:
+// normal [0..2], edge normals [3..11], edge offsets [12..14], area [15].
+static_assert(sizeof(TriangleFrame) == 16 * sizeof(float), "TriangleFrame layout changed");
+
+constexpr int c_FrameStride = 16;
+constexpr int c_EdgeNormalsOffset = 3;
+constexpr int c_EdgeOffsetsOffset = 12;
+
+// AVX2 gathers take int32 float offsets (triangle * c_FrameStride), so they only reach this many frames.
+constexpr size_t c_MaxGatherFrames = static_cast<size_t>(std::numeric_limits<int32_t>::max()) / c_FrameStride + 1;
+
+void stepScalar(const MeshTopology &topology, const TriangleFrames &frames, const SurfaceParticleArrays &particles,
+                size_t i, glm::vec3 position, float distance, SurfaceStepper::Result &result) {
+    glm::vec3 velocity(particles.vx[i], particles.vy[i], particles.vz[i]);
+
+    auto stepResult = SurfaceStepper::step(topology, frames, position, velocity, particles.triangles[i], distance);
+
+    particles.px[i] = position.x;
+    particles.py[i] = position.y;
+    particles.pz[i] = position.z;
+    particles.vx[i] = velocity.x;
+    particles.vy[i] = velocity.y;
+    particles.vz[i] = velocity.z;
+
+    result.crossings += stepResult.crossings;
+    result.bounces += stepResult.bounces;
+}
+
+void updateScalar(const MeshTopology &topology, const TriangleFrames &frames, const SurfaceParticleArrays &particles,
+                  size_t begin, size_t end, float deltaSeconds, SurfaceStepper::Result &result) {
+    for (size_t i = begin; i < end; i++) {
+        glm::vec3 position(particles.px[i], particles.py[i], particles.pz[i]);
+        particles.ox[i] = position.x;
+        particles.oy[i] = position.y;
+        particles.oz[i] = position.z;
+        stepScalar(topology, frames, particles, i, position, particles.speeds[i] * deltaSeconds, result);
+    }
+}
+
+void writeTransform(float *row, const float *normal, float px, float py, float pz, float vx, float vy, float vz) {
+    float nx = normal[0], ny = normal[1], nz = normal[2];
+
+    // Remove the normal component so the basis stays orthonormal even if the
+    // velocity drifted slightly off the triangle plane.
+    float along = vx * nx + vy * ny + vz * nz;
+    vx -= nx * along;
+    vy -= ny * along;
+    vz -= nz * along;
+
+    float length = std::sqrt(vx * vx + vy * vy + vz * vz);
+    float scale = length > 0.0f ? 1.0f / length : 0.0f;
+    vx *= scale;
+    vy *= scale;
+    vz *= scale;
+
+    float xx = vy * nz - vz * ny;
+    float xy = vz * nx - vx * nz;
+    float xz = vx * ny - vy * nx;
+
+    const float matrix[12] = {xx, nx, -vx, px, xy, ny, -vy, py, xz, nz, -vz, pz};
+    std::copy(matrix, matrix + 12, row);
+}
+
+void writeParticleTransform(const float *frameData, const SurfaceParticleArrays &particles, size_t i, float alpha,
+                            float *row) {
+    const float *normal = frameData + static_cast<size_t>(particles.triangles[i]) * c_FrameStride;
+
+    float px = particles.ox[i] + (particles.px[i] - particles.ox[i]) * alpha;
+    float py = particles.oy[i] + (particles.py[i] - particles.oy[i]) * alpha;
+    float pz = particles.oz[i] + (particles.pz[i] - particles.oz[i]) * alpha;
+
+    writeTransform(row, normal, px, py, pz, particles.vx[i], particles.vy[i], particles.vz[i]);
+}
+
+void writeTransformsScalar(const TriangleFrames &frames, const SurfaceParticleArrays &particles, size_t begin,
+                           size_t end, float alpha, float *rows) {
+    const float *frameData = reinterpret_cast<const float *>(frames.frames.data());
+
+    for (size_t i = begin; i < end; i++) {
+        writeParticleTransform(frameData, particles, i, alpha, rows + i * SurfaceKernels::c_TransformFloats);
+    }
+}
+
+#if ENGINE_SIMD_X86
+
+__attribute__((target("sse4.1"))) void updateSSE4(const MeshTopology &topology, const TriangleFrames &frames,
+                                                   const SurfaceParticleArrays &particles, size_t begin, size_t end,
+                                                   float deltaSeconds, SurfaceStepper::Result &result) {
+    const float *frameData = reinterpret_cast<const float *>(frames.frames.data());
+    const __m128 dt = _mm_set1_ps(deltaSeconds);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 px = _mm_loadu_ps(particles.px + i);
+        __m128 py = _mm_loadu_ps(particles.py + i);
+        __m128 pz = _mm_loadu_ps(particles.pz + i);
+        __m128 vx = _mm_loadu_ps(particles.vx + i);
+        __m128 vy = _mm_loadu_ps(particles.vy + i);
+        __m128 vz = _mm_loadu_ps(particles.vz + i);
+        __m128 distance = _mm_mul_ps(_mm_loadu_ps(particles.speeds + i), dt);
+
+        _mm_storeu_ps(particles.ox + i, px);
+        _mm_storeu_ps(particles.oy + i, py);
+        _mm_storeu_ps(particles.oz + i, pz);
+
+        const float *f0 = frameData + static_cast<size_t>(particles.triangles[i]) * c_FrameStride;
+        const float *f1 = frameData + static_cast<size_t>(particles.triangles[i + 1]) * c_FrameStride;
+        const float *f2 = frameData + static_cast<size_t>(particles.triangles[i + 2]) * c_FrameStride;
+        const float *f3 = frameData + static_cast<size_t>(particles.triangles[i + 3]) * c_FrameStride;
+
+        __m128 exitTime = infinity;
+        for (int edge = 0; edge < 3; edge++) {
+            int n = c_EdgeNormalsOffset + edge * 3;
+            int o = c_EdgeOffsetsOffset + edge;
+
+            __m128 nx = _mm_setr_ps(f0[n], f1[n], f2[n], f3[n]);
+            __m128 ny = _mm_setr_ps(f0[n + 1], f1[n + 1], f2[n + 1], f3[n + 1]);
+            __m128 nz = _mm_setr_ps(f0[n + 2], f1[n + 2], f2[n + 2], f3[n + 2]);
+            __m128 offset = _mm_setr_ps(f0[o], f1[o], f2[o], f3[o]);
+
+            __m128 rate = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, vx), _mm_mul_ps(ny, vy)), _mm_mul_ps(nz, vz));
+            __m128 gap = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, px), _mm_mul_ps(ny, py)), _mm_mul_ps(nz, pz));
+            gap = _mm_max_ps(_mm_sub_ps(gap, offset), zero);
+
+            __m128 time = _mm_div_ps(gap, _mm_sub_ps(zero, rate));
+            __m128 leaving = _mm_cmplt_ps(rate, zero);
+            exitTime = _mm_min_ps(exitTime, _mm_blendv_ps(infinity, time, leaving));
+        }
+
+        int crossing = _mm_movemask_ps(_mm_cmplt_ps(exitTime, distance));
+
+        alignas(16) float x[4], y[4], z[4];
+        _mm_store_ps(x, px);
+        _mm_store_ps(y, py);
+        _mm_store_ps(z, pz);
+
+        _mm_storeu_ps(particles.px + i, _mm_add_ps(px, _mm_mul_ps(vx, distance)));
+        _mm_storeu_ps(particles.py + i, _mm_add_ps(py, _mm_mul_ps(vy, distance)));
+        _mm_storeu_ps(particles.pz + i, _mm_add_ps(pz, _mm_mul_ps(vz, distance)));
+
+        while (crossing != 0) {
+            int lane = __builtin_ctz(static_cast<unsigned>(crossing));
+            crossing &= crossing - 1;
+            stepScalar(topology, frames, particles, i + lane, glm::vec3(x[lane], y[lane], z[lane]),
+                       particles.speeds[i + lane] * deltaSeconds, result);
+        }
+    }
+
+    updateScalar(topology, frames, particles, i, end, deltaSeconds, result);
+}
+
+__attribute__((target("avx2,fma"))) void updateAVX2(const MeshTopology &topology, const TriangleFrames &frames,
+                                                     const SurfaceParticleArrays &particles, size_t begin, size_t end,
+                                                     float deltaSeconds, SurfaceStepper::Result &result) {
+    const float *frameData = reinterpret_cast<const float *>(frames.frames.data());
+    const __m256 dt = _mm256_set1_ps(deltaSeconds);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 infinity = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 px = _mm256_loadu_ps(particles.px + i);
+        __m256 py = _mm256_loadu_ps(particles.py + i);
+        __m256 pz = _mm256_loadu_ps(particles.pz + i);
+        __m256 vx = _mm256_loadu_ps(particles.vx + i);
+        __m256 vy = _mm256_loadu_ps(particles.vy + i);
+        __m256 vz = _mm256_loadu_ps(particles.vz + i);
+        __m256 distance = _mm256_mul_ps(_mm256_loadu_ps(particles.speeds + i), dt);
+
+        _mm256_storeu_ps(particles.ox + i, px);
+        _mm256_storeu_ps(particles.oy + i, py);
+        _mm256_storeu_ps(particles.oz + i, pz);
+
+        __m256i triangles = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(particles.triangles + i));
+        __m256i base = _mm256_slli_epi32(triangles, 4);
+
+        __m256 exitTime = infinity;
+        for (int edge = 0; edge < 3; edge++) {
+            const float *normals = frameData + c_EdgeNormalsOffset + edge * 3;
+
+            __m256 nx = _mm256_i32gather_ps(normals, base, 4);
+            __m256 ny = _mm256_i32gather_ps(normals + 1, base, 4);
+            __m256 nz = _mm256_i32gather_ps(normals + 2, base, 4);
+            __m256 offset = _mm256_i32gather_ps(frameData + c_EdgeOffsetsOffset + edge, base, 4);
+
+            __m256 rate = _mm256_fmadd_ps(nz, vz, _mm256_fmadd_ps(ny, vy, _mm256_mul_ps(nx, vx)));
+            __m256 gap = _mm256_fmadd_ps(nz, pz, _mm256_fmadd_ps(ny, py, _mm256_mul_ps(nx, px)));
+            gap = _mm256_max_ps(_mm256_sub_ps(gap, offset), zero);
+
+            __m256 time = _mm256_div_ps(gap, _mm256_sub_ps(zero, rate));
+            __m256 leaving = _mm256_cmp_ps(rate, zero, _CMP_LT_OQ);
+            exitTime = _mm256_min_ps(exitTime, _mm256_blendv_ps(infinity, time, leaving));
+        }
+
+        int crossing = _mm256_movemask_ps(_mm256_cmp_ps(exitTime, distance, _CMP_LT_OQ));
+
+        alignas(32) float x[8], y[8], z[8];
+        _mm256_store_ps(x, px);
+        _mm256_store_ps(y, py);
+        _mm256_store_ps(z, pz);
+
+        _mm256_storeu_ps(particles.px + i, _mm256_fmadd_ps(vx, distance, px));
+        _mm256_storeu_ps(particles.py + i, _mm256_fmadd_ps(vy, distance, py));
+        _mm256_storeu_ps(particles.pz + i, _mm256_fmadd_ps(vz, distance, pz));
+
+        while (crossing != 0) {
+            int lane = __builtin_ctz(static_cast<unsigned>(crossing));
+            crossing &= crossing - 1;
+            stepScalar(topology, frames, particles, i + lane, glm::vec3(x[lane], y[lane], z[lane]),
+                       particles.speeds[i + lane] * deltaSeconds, result);
+        }
+    }
+
+    updateScalar(topology, frames, particles, i, end, deltaSeconds, result);
+}
+
+__attribute__((target("avx2,fma"))) inline __m256 lerp(__m256 from, __m256 to, __m256 t) {
+    return _mm256_fmadd_ps(_mm256_sub_ps(to, from), t, from);
+}
+
+__attribute__((target("avx2,fma"))) void writeTransformsAVX2(const TriangleFrames &frames,
+                                                              const SurfaceParticleArrays &particles, size_t begin,
+                                                              size_t end, float alpha, float *rows) {
+    const float *frameData = reinterpret_cast<const float *>(frames.frames.data());
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 t = _mm256_set1_ps(alpha);
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 vx = _mm256_loadu_ps(particles.vx + i);
+        __m256 vy = _mm256_loadu_ps(particles.vy + i);
+        __m256 vz = _mm256_loadu_ps(particles.vz + i);
+
+        __m256i triangles = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(particles.triangles + i));
+        __m256i base = _mm256_slli_epi32(triangles, 4);
+
+        __m256 nx = _mm256_i32gather_ps(frameData, base, 4);
+        __m256 ny = _mm256_i32gather_ps(frameData + 1, base, 4);
+        __m256 nz = _mm256_i32gather_ps(frameData + 2, base, 4);
+
+        __m256 along = _mm256_fmadd_ps(nz, vz, _mm256_fmadd_ps(ny, vy, _mm256_mul_ps(nx, vx)));
+        vx = _mm256_fnmadd_ps(nx, along, vx);
+        vy = _mm256_fnmadd_ps(ny, along, vy);
+        vz = _mm256_fnmadd_ps(nz, along, vz);
+
+        __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(vz, vz, _mm256_fmadd_ps(vy, vy, _mm256_mul_ps(vx, vx))));
+        __m256 scale = _mm256_and_ps(_mm256_div_ps(one, length), _mm256_cmp_ps(length, zero, _CMP_GT_OQ));
+        vx = _mm256_mul_ps(vx, scale);
+        vy = _mm256_mul_ps(vy, scale);
+        vz = _mm256_mul_ps(vz, scale);
+
+        // Columns of the 3x4 matrix, one register per matrix element.
+        alignas(32) float m[12][8];
+        _mm256_store_ps(m[0], _mm256_fmsub_ps(vy, nz, _mm256_mul_ps(vz, ny)));
+        _mm256_store_ps(m[1], nx);
+        _mm256_store_ps(m[2], _mm256_sub_ps(zero, vx));
+        _mm256_store_ps(m[3], lerp(_mm256_loadu_ps(particles.ox + i), _mm256_loadu_ps(particles.px + i), t));
+        _mm256_store_ps(m[4], _mm256_fmsub_ps(vz, nx, _mm256_mul_ps(vx, nz)));
+        _mm256_store_ps(m[5], ny);
+        _mm256_store_ps(m[6], _mm256_sub_ps(zero, vy));
+        _mm256_store_ps(m[7], lerp(_mm256_loadu_ps(particles.oy + i), _mm256_loadu_ps(particles.py + i), t));
+        _mm256_store_ps(m[8], _mm256_fmsub_ps(vx, ny, _mm256_mul_ps(vy, nx)));
+        _mm256_store_ps(m[9], nz);
+        _mm256_store_ps(m[10], _mm256_sub_ps(zero, vz));
+        _mm256_store_ps(m[11], lerp(_mm256_loadu_ps(particles.oz + i), _mm256_loadu_ps(particles.pz + i), t));
+
+        float *out = rows + i * SurfaceKernels::c_TransformFloats;
+        for (int lane = 0; lane < 8; lane++) {
+            for (int k = 0; k < 12; k++) {
+                out[lane * 12 + k] = m[k][lane];
+            }
+        }
+    }
+
+    writeTransformsScalar(frames, particles, i, end, alpha, rows);
+}
+
+#endif
+
+} // namespace
+
+SimdLevel SurfaceKernels::detect() {
+    if (isSupported(SimdLevel::AVX2)) {
+        return SimdLevel::AVX2;
+    }
+
+    if (isSupported(SimdLevel::SSE4)) {
+        return SimdLevel::SSE4;
+    }
+
+    return SimdLevel::Scalar;
+}
+
+bool SurfaceKernels::isSupported(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar:
+        return true;
+#if ENGINE_SIMD_X86
+    case SimdLevel::SSE4:
+        return __builtin_cpu_supports("sse4.1");
+    case SimdLevel::AVX2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    default:
+        return false;
+    }
+}
+
+const char *SurfaceKernels::name(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::SSE4:
+        return "sse4";
+    case SimdLevel::AVX2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+SurfaceStepper::Result SurfaceKernels::update(SimdLevel level, const MeshTopology &topology,
+                                              const TriangleFrames &frames, const SurfaceParticleArrays &particles,
+                                              size_t begin, size_t end, float deltaSeconds) {
+    SurfaceStepper::Result result;
+
+    if (level == SimdLevel::AVX2 && frames.frames.size() > c_MaxGatherFrames) {
+        level = SimdLevel::SSE4;
+    }
+
+    switch (level) {
+#if ENGINE_SIMD_X86
+    case SimdLevel::AVX2:
+        updateAVX2(topology, frames, particles, begin, end, deltaSeconds, result);
+        break;
+    case SimdLevel::SSE4:
+        updateSSE4(topology, frames, particles, begin, end, deltaSeconds, result);
+        break;
+#endif
+    default:
+        updateScalar(topology, frames, particles, begin, end, deltaSeconds, result);
+        break;
+    }
+
+    return result;
+}
+
+void SurfaceKernels::writeTransforms(SimdLevel level, const TriangleFrames &frames,
+                                     const SurfaceParticleArrays &particles, size_t begin, size_t end, float alpha,
+                                     float *rows) {
+#if ENGINE_SIMD_X86
+    if (level == SimdLevel::AVX2 && frames.frames.size() <= c_MaxGatherFrames) {
+        writeTransformsAVX2(frames, particles, begin, end, alpha, rows);
+        return;
+    }
+#endif
+
+    writeTransformsScalar(frames, particles, begin, end, alpha, rows);
+}
+
+void SurfaceKernels::writeTransforms(const TriangleFrames &frames, const SurfaceParticleArrays &particles,
+                                     const uint32_t *indices, size_t count, float alpha, float *rows) {
+    const float *frameData = reinterpret_cast<const float *>(frames.frames.data());
+
+    for (size_t j = 0; j < count; j++) {
+        writeParticleTransform(frameData, particles, indices[j], alpha, rows + j * c_TransformFloats);
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "MeshTopology.hpp"
+#include "SimdLevel.hpp"
+#include "SurfaceStepper.hpp"
+#include "TriangleFrames.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine {
+
+/**
+ * Raw views of the particle arrays a batch kernel reads and writes. The
+ * update kernels save each position to ox/oy/oz before moving it, so the
+ * state before the last step stays available for interpolation.
+ */
+struct SurfaceParticleArrays {
+    float *px, *py, *pz;
+    float *vx, *vy, *vz;
+    float *ox, *oy, *oz;
+    const float *speeds;
+    uint32_t *triangles;
+};
+
+/**
+ * Batch update of surface particles. The vector kernels test 4 (SSE4) or 8
+ * (AVX2) particles at once against the edge planes of their triangles and
+ * advance every particle that stays inside; particles that reach an edge
+ * this step are finished by SurfaceStepper.
+ */
+class SurfaceKernels {
+  public:
+    static SimdLevel detect();
+    static bool isSupported(SimdLevel level);
+    static const char *name(SimdLevel level);
+
+    static SurfaceStepper::Result update(SimdLevel level, const MeshTopology &topology, const TriangleFrames &frames,
+                                         const SurfaceParticleArrays &particles, size_t begin, size_t end,
+                                         float deltaSeconds);
+
+    /**
+     * Writes particles [begin, end) as packed 3x4 row-major transforms, 12
+     * floats per particle at rows + 12 * i. The basis is X = cross(v, N),
+     * Y = N, Z = -v, with v projected onto the triangle plane. The position
+     * is interpolated from the previous one by alpha in [0, 1].
+     */
+    static void writeTransforms(SimdLevel level, const TriangleFrames &frames, const SurfaceParticleArrays &particles,
+                                size_t begin, size_t end, float alpha, float *rows);
+
+    /**
+     * Writes the listed particles only, packed: transform j, at rows + 12 * j,
+     * belongs to particle indices[j]. Used after culling.
+     */
+    static void writeTransforms(const TriangleFrames &frames, const SurfaceParticleArrays &particles,
+                                const uint32_t *indices, size_t count, float alpha, float *rows);
+
+    static constexpr size_t c_TransformFloats = 12;
+};
+
+} // namespace Engine
@@ -0,0 +1,515 @@
+#include "SurfaceParticleSystem.hpp"
+
+#include "Math.hpp"
+#include "Random.hpp"
+#include "SurfaceKernels.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace Engine {
+
+namespace {
+
+// Positions, previous positions and velocities as x, y, z, then speeds and triangles
+constexpr size_t c_SnapshotArrays = 11;
+
+// (a, b) such that offset = a * (P1 - P0) + b * (P2 - P0), for an offset in the triangle plane
+glm::vec2 edgeCoordinates(const glm::vec3 *corners, glm::vec3 offset) {
+    glm::vec3 e1 = corners[1] - corners[0];
+    glm::vec3 e2 = corners[2] - corners[0];
+
+    float d11 = glm::dot(e1, e1);
+    float d12 = glm::dot(e1, e2);
+    float d22 = glm::dot(e2, e2);
+    float determinant = d11 * d22 - d12 * d12;
+    if (determinant <= 0.0f) {
+        return glm::vec2(1.0f / 3.0f);
+    }
+
+    float o1 = glm::dot(offset, e1);
+    float o2 = glm::dot(offset, e2);
+    return glm::vec2(d22 * o1 - d12 * o2, d11 * o2 - d12 * o1) / determinant;
+}
+
+} // namespace
+
+SurfaceParticleSystem::SurfaceParticleSystem(Mesh &surface)
+    : m_Surface(surface), m_SimdLevel(SurfaceKernels::detect()), m_Seed(Math::getSeed()) {
+    if (m_Surface.topology.empty()) {
+        m_Surface.buildTopology();
+    }
+    if (m_Surface.frames.empty()) {
+        m_Surface.buildFrames();
+    }
+    if (m_Surface.sampler.empty()) {
+        m_Surface.buildSampler();
+    }
+    if (m_Surface.positions.empty()) {
+        m_Surface.buildPositions();
+    }
+
+    m_SurfaceListener = m_Surface.addChangeListener([this](const MeshChange &change) { onSurfaceChanged(change); });
+}
+
+SurfaceParticleSystem::~SurfaceParticleSystem() { m_Surface.removeChangeListener(m_SurfaceListener); }
+
+size_t SurfaceParticleSystem::grow(size_t count) {
+    size_t offset = size();
+    m_Positions.resize(offset + count);
+    m_PreviousPositions.resize(offset + count);
+    m_Velocities.resize(offset + count);
+    m_Speeds.resize(offset + count, m_Speed);
+    m_Triangles.resize(offset + count);
+    m_TriangleIndex.invalidate();
+    return offset;
+}
+
+void SurfaceParticleSystem::spawn(size_t count) {
+    m_Surface.updateSampler();
+    if (m_Surface.sampler.empty()) {
+        return;
+    }
+
+    size_t offset = grow(count);
+    spawnRange(offset, offset + count);
+}
+
+void SurfaceParticleSystem::spawn(size_t count, JobPool &jobs) {
+    m_Surface.updateSampler();
+    if (m_Surface.sampler.empty()) {
+        return;
+    }
+
+    size_t offset = grow(count);
+    jobs.parallelFor(count, m_ChunkSize,
+                     [this, offset](size_t begin, size_t end, unsigned) { spawnRange(offset + begin, offset + end); });
+}
+
+void SurfaceParticleSystem::spawnRange(size_t begin, size_t end) {
+    const SurfaceSampler &sampler = m_Surface.sampler;
+    uint32_t triangles = static_cast<uint32_t>(sampler.size());
+
+    for (size_t i = begin; i < end; i++) {
+        // One stream per particle index, so the result does not depend on how spawning was split up.
+        Random random(m_Seed, i);
+
+        uint32_t column = random.nextBelow(triangles);
+        uint32_t triangle = sampler.sample(column, random.nextFloat());
+
+        glm::vec3 weights = SurfaceSampler::barycentric(random.nextFloat(), random.nextFloat());
+        glm::vec3 P = getCorner(triangle, 0) * weights.x + getCorner(triangle, 1) * weights.y +
+                      getCorner(triangle, 2) * weights.z;
+
+        // Uniform heading in the triangle plane
+        const TriangleBasis &basis = m_Surface.frames.basis(triangle);
+        glm::vec3 T = basis.tangent;
+        glm::vec3 B = basis.bitangent;
+        float angle = random.nextFloat() * 2.0f * Math::c_Pi;
+
+        m_Positions.set(i, P);
+        m_PreviousPositions.set(i, P);
+        m_Velocities.set(i, T * std::cos(angle) + B * std::sin(angle));
+        m_Triangles[i] = triangle;
+    }
+}
+
+void SurfaceParticleSystem::clear() {
+    m_Positions.clear();
+    m_PreviousPositions.clear();
+    m_Velocities.clear();
+    m_Speeds.clear();
+    m_Triangles.clear();
+    m_TriangleIndex.invalidate();
+}
+
+SurfaceParticleArrays SurfaceParticleSystem::getArrays() {
+    return SurfaceParticleArrays{m_Positions.x.data(),         m_Positions.y.data(),         m_Positions.z.data(),
+                                 m_Velocities.x.data(),        m_Velocities.y.data(),        m_Velocities.z.data(),
+                                 m_PreviousPositions.x.data(), m_PreviousPositions.y.data(), m_PreviousPositions.z.data(),
+                                 m_Speeds.data(),              m_Triangles.data()};
+}
+
+void SurfaceParticleSystem::addStats(unsigned slot, const SurfaceStepper::Result &result) {
+    m_Stats[slot].crossings += result.crossings;
+    m_Stats[slot].bounces += result.bounces;
+}
+
+void SurfaceParticleSystem::update(float deltaSeconds) {
+    if (m_Stats.empty()) {
+        m_Stats.resize(1);
+    }
+    m_TriangleIndex.invalidate();
+
+    if (m_SeparationRadius > 0.0f) {
+        prepareSeparation();
+        separateRange(0, size(), deltaSeconds);
+    }
+
+    auto result = SurfaceKernels::update(m_SimdLevel, m_Surface.topology, m_Surface.frames, getArrays(), 0, size(),
+                                         deltaSeconds);
+    addStats(0, result);
+}
+
+void SurfaceParticleSystem::update(float deltaSeconds, JobPool &jobs) {
+    if (m_Stats.size() < jobs.getSlotCount()) {
+        m_Stats.resize(jobs.getSlotCount());
+    }
+    m_TriangleIndex.invalidate();
+
+    // Chunk sizes are kept on multiples of 16 particles so no SIMD batch is
+    // split and neighbouring chunks share at most one cache line per array.
+    size_t chunkSize = std::max<size_t>((m_ChunkSize + 15) & ~size_t(15), 16);
+
+    // May reorder the arrays, so it has to run before their pointers are taken.
+    bool separate = m_SeparationRadius > 0.0f;
+    if (separate) {
+        prepareSeparation();
+    }
+
+    SurfaceParticleArrays arrays = getArrays();
+
+    jobs.parallelFor(size(), chunkSize, [this, arrays, deltaSeconds, separate](size_t begin, size_t end,
+                                                                              unsigned worker) {
+        // Steering writes only this chunk's velocities and reads neighbours
+        // from the grid snapshot, so chunks never see each other's moves.
+        if (separate) {
+            separateRange(begin, end, deltaSeconds);
+        }
+
+        auto result =
+            SurfaceKernels::update(m_SimdLevel, m_Surface.topology, m_Surface.frames, arrays, begin, end, deltaSeconds);
+        addStats(worker, result);
+    });
+}
+
+bool SurfaceParticleSystem::saveSnapshot(const std::string &path) const {
+    return ParticleSnapshot::write(path, createSnapshotHeader(), getSnapshotArrays());
+}
+
+std::future<bool> SurfaceParticleSystem::saveSnapshotAsync(const std::string &path) const {
+    return ParticleSnapshot::writeAsync(path, createSnapshotHeader(), getSnapshotArrays());
+}
+
+bool SurfaceParticleSystem::loadSnapshot(const std::string &path) {
+    ParticleSnapshot snapshot;
+    if (!openSnapshot(path, snapshot)) {
+        return false;
+    }
+
+    bool valid = true;
+    for (size_t i = 0; i < c_SnapshotArrays; i++) {
+        valid = restoreArray(snapshot, i) && valid;
+    }
+
+    return finishRestore(path, snapshot, valid);
+}
+
+bool SurfaceParticleSystem::loadSnapshot(const std::string &path, JobPool &jobs) {
+    ParticleSnapshot snapshot;
+    if (!openSnapshot(path, snapshot)) {
+        return false;
+    }
+
+    // One job per array: each is a single allocation and copy, with no zero fill first.
+    std::vector<uint8_t> valid(c_SnapshotArrays, 0);
+    JobPool::Batch batch;
+    for (size_t i = 0; i < c_SnapshotArrays; i++) {
+        jobs.submit([this, &snapshot, &valid, i](unsigned) { valid[i] = restoreArray(snapshot, i); }, batch);
+    }
+    jobs.wait(batch);
+
+    return finishRestore(path, snapshot, std::find(valid.begin(), valid.end(), 0) == valid.end());
+}
+
+ParticleSnapshot::Header SurfaceParticleSystem::createSnapshotHeader() const {
+    ParticleSnapshot::Header header = ParticleSnapshot::createHeader(size(), c_SnapshotArrays);
+    header.seed = m_Seed;
+    header.stepsSinceSort = m_StepsSinceSort;
+    header.surfaceVertices = m_Surface.vertices.size();
+    header.surfaceTriangles = m_Surface.topology.triangleCount();
+    header.speed = m_Speed;
+    return header;
+}
+
+std::vector<const void *> SurfaceParticleSystem::getSnapshotArrays() const {
+    return {m_Positions.x.data(),         m_Positions.y.data(),         m_Positions.z.data(),
+            m_PreviousPositions.x.data(), m_PreviousPositions.y.data(), m_PreviousPositions.z.data(),
+            m_Velocities.x.data(),        m_Velocities.y.data(),        m_Velocities.z.data(),
+            m_Speeds.data(),              m_Triangles.data()};
+}
+
+bool SurfaceParticleSystem::openSnapshot(const std::string &path, ParticleSnapshot &snapshot) const {
+    if (!snapshot.open(path)) {
+        return false;
+    }
+
+    const ParticleSnapshot::Header &header = snapshot.getHeader();
+    if (header.arrayCount != c_SnapshotArrays || header.surfaceVertices != m_Surface.vertices.size() ||
+        header.surfaceTriangles != m_Surface.topology.triangleCount()) {
+        std::cerr << "SurfaceParticleSystem: snapshot " << path << " was taken on a different surface\n";
+        return false;
+    }
+
+    snapshot.adviseSequential();
+    return true;
+}
+
+bool SurfaceParticleSystem::restoreArray(const ParticleSnapshot &snapshot, size_t index) {
+    size_t count = snapshot.size();
+
+    if (index == c_SnapshotArrays - 1) {
+        const uint32_t *triangles = static_cast<const uint32_t *>(snapshot.array(index));
+        m_Triangles.assign(triangles, triangles + count);
+
+        // The walkers index frames with these unchecked.
+        uint32_t triangleCount = static_cast<uint32_t>(m_Surface.topology.triangleCount());
+        return std::all_of(m_Triangles.begin(), m_Triangles.end(),
+                           [triangleCount](uint32_t triangle) { return triangle < triangleCount; });
+    }
+
+    std::vector<float> *arrays[c_SnapshotArrays - 1] = {
+        &m_Positions.x,         &m_Positions.y,         &m_Positions.z,  &m_PreviousPositions.x, &m_PreviousPositions.y,
+        &m_PreviousPositions.z, &m_Velocities.x,        &m_Velocities.y, &m_Velocities.z,        &m_Speeds};
+
+    const float *values = static_cast<const float *>(snapshot.array(index));
+    arrays[index]->assign(values, values + count);
+    return true;
+}
+
+bool SurfaceParticleSystem::finishRestore(const std::string &path, const ParticleSnapshot &snapshot, bool valid) {
+    if (!valid) {
+        clear();
+        std::cerr << "SurfaceParticleSystem: snapshot " << path << " refers to missing triangles\n";
+        return false;
+    }
+    m_TriangleIndex.invalidate();
+
+    const ParticleSnapshot::Header &header = snapshot.getHeader();
+    m_Seed = header.seed;
+    m_StepsSinceSort = header.stepsSinceSort;
+    m_Speed = header.speed;
+    return true;
+}
+
+void SurfaceParticleSystem::onSurfaceChanged(const MeshChange &change) {
+    if (change.rebuilt) {
+        // Triangle ids from before mean nothing on the new surface.
+        size_t count = size();
+        clear();
+        spawn(count);
+        return;
+    }
+
+    if (change.triangles.empty()) {
+        return;
+    }
+
+    if (!m_TriangleIndex.prepare(m_Triangles, m_Surface.topology.triangleCount())) {
+        for (size_t i = 0; i < size(); i++) {
+            const glm::vec3 *previous = change.previous(m_Triangles[i]);
+            if (previous != nullptr) {
+                reproject(i, previous);
+            }
+        }
+        return;
+    }
+
+    for (size_t t = 0; t < change.triangles.size(); t++) {
+        const glm::vec3 *previous = &change.previousCorners[t * 3];
+        m_TriangleIndex.forEachOn(change.triangles[t], [this, previous](uint32_t i) { reproject(i, previous); });
+    }
+}
+
+void SurfaceParticleSystem::reproject(size_t index, const glm::vec3 *previousCorners) {
+    uint32_t triangle = m_Triangles[index];
+    glm::vec3 P0 = getCorner(triangle, 0);
+    glm::vec3 e1 = getCorner(triangle, 1) - P0;
+    glm::vec3 e2 = getCorner(triangle, 2) - P0;
+
+    // Carry everything over through the affine map between the old and new
+    // triangle; only the current position has to stay strictly inside.
+    glm::vec2 uv = glm::max(edgeCoordinates(previousCorners, m_Positions.get(index) - previousCorners[0]),
+                            glm::vec2(0.0f));
+    if (uv.x + uv.y > 1.0f) {
+        uv /= uv.x + uv.y;
+    }
+    glm::vec2 previousUv = edgeCoordinates(previousCorners, m_PreviousPositions.get(index) - previousCorners[0]);
+    glm::vec2 heading = edgeCoordinates(previousCorners, m_Velocities.get(index));
+
+    m_Positions.set(index, P0 + e1 * uv.x + e2 * uv.y);
+    m_PreviousPositions.set(index, P0 + e1 * previousUv.x + e2 * previousUv.y);
+
+    glm::vec3 N = getTriangleNormal(triangle);
+    glm::vec3 velocity = e1 * heading.x + e2 * heading.y;
+    velocity -= N * glm::dot(velocity, N);
+
+    float length = glm::length(velocity);
+    m_Velocities.set(index, length > 0.0f ? velocity / length : m_Surface.frames.basis(triangle).tangent);
+}
+
+void SurfaceParticleSystem::setSeparation(float radius, float strength) {
+    m_SeparationRadius = std::max(radius, 0.0f);
+    m_SeparationStrength = strength;
+
+    if (m_SeparationRadius > 0.0f) {
+        m_Grid.setCellSize(m_SeparationRadius * 2.0f);
+    } else {
+        m_Grid.clear();
+    }
+}
+
+void SurfaceParticleSystem::sortBySpace() {
+    buildGrid();
+
+    std::vector<uint32_t> order(size());
+    for (size_t slot = 0; slot < order.size(); slot++) {
+        order[slot] = m_Grid.indexAt(slot);
+    }
+
+    permute(m_Positions.x, order);
+    permute(m_Positions.y, order);
+    permute(m_Positions.z, order);
+    permute(m_PreviousPositions.x, order);
+    permute(m_PreviousPositions.y, order);
+    permute(m_PreviousPositions.z, order);
+    permute(m_Velocities.x, order);
+    permute(m_Velocities.y, order);
+    permute(m_Velocities.z, order);
+    permute(m_Speeds, order);
+    permute(m_Triangles, order);
+    m_TriangleIndex.invalidate();
+
+    m_StepsSinceSort = 0;
+}
+
+void SurfaceParticleSystem::buildGrid() {
+    m_Grid.build(m_Positions.x.data(), m_Positions.y.data(), m_Positions.z.data(), size());
+}
+
+void SurfaceParticleSystem::prepareSeparation() {
+    // Particles drift apart in memory as they move; re-sorting now and then
+    // keeps neighbours close in the arrays, which the queries depend on.
+    if (m_SortInterval > 0 && m_StepsSinceSort >= m_SortInterval) {
+        sortBySpace();
+    }
+
+    buildGrid();
+    m_StepsSinceSort++;
+}
+
+template <typename T> void SurfaceParticleSystem::permute(std::vector<T> &values, const std::vector<uint32_t> &order) {
+    std::vector<T> sorted(values.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        sorted[i] = values[order[i]];
+    }
+    values.swap(sorted);
+}
+
+void SurfaceParticleSystem::separateRange(size_t begin, size_t end, float deltaSeconds) {
+    float radius = m_SeparationRadius;
+    float inverseRadius = 1.0f / radius;
+    float gain = m_SeparationStrength * deltaSeconds;
+
+    for (size_t i = begin; i < end; i++) {
+        glm::vec3 position = m_Positions.get(i);
+        glm::vec3 push(0.0f);
+
+        m_Grid.forEachInRadius(position, radius, [&](uint32_t index, const glm::vec3 &point, float distanceSquared) {
+            if (index == i || distanceSquared <= 0.0f) {
+                return;
+            }
+            float distance = std::sqrt(distanceSquared);
+            push += (position - point) * ((1.0f - distance * inverseRadius) / distance);
+        });
+
+        if (push == glm::vec3(0.0f)) {
+            continue;
+        }
+
+        // Keep the heading in the triangle plane and of unit length, as the walker expects.
+        glm::vec3 N = getTriangleNormal(m_Triangles[i]);
+        glm::vec3 velocity = m_Velocities.get(i) + push * gain;
+        velocity -= N * glm::dot(velocity, N);
+
+        float length = glm::length(velocity);
+        if (length > 0.0f) {
+            m_Velocities.set(i, velocity / length);
+        }
+    }
+}
+
+SurfaceParticleSystem::Stats SurfaceParticleSystem::getStats() const {
+    Stats total;
+    for (const auto &stats : m_Stats) {
+        total.crossings += stats.crossings;
+        total.bounces += stats.bounces;
+    }
+    return total;
+}
+
+glm::mat4 SurfaceParticleSystem::getTransform(size_t index) const {
+    glm::vec3 N = getTriangleNormal(m_Triangles[index]);
+    glm::vec3 velocity = m_Velocities.get(index);
+    glm::vec3 forward = glm::normalize(velocity - N * glm::dot(velocity, N));
+
+    return glm::mat4(glm::vec4(glm::cross(forward, N), 0.0f), glm::vec4(N, 0.0f), glm::vec4(-forward, 0.0f),
+                     glm::vec4(m_Positions.get(index), 1.0f));
+}
+
+void SurfaceParticleSystem::writeTransforms(float *rows, float alpha) {
+    auto start = std::chrono::steady_clock::now();
+
+    SurfaceKernels::writeTransforms(m_SimdLevel, m_Surface.frames, getArrays(), 0, size(), alpha, rows);
+
+    if (size() > 0) {
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        m_TransformNanoseconds = elapsed / static_cast<double>(size());
+    }
+}
+
+size_t SurfaceParticleSystem::cull(const Frustum &frustum, float radius, std::vector<uint32_t> &visible) const {
+    visible.resize(size());
+    size_t count = frustum.cullSpheres(m_SimdLevel, m_Positions.x.data(), m_Positions.y.data(), m_Positions.z.data(),
+                                       size(), radius, visible.data());
+    visible.resize(count);
+    return count;
+}
+
+void SurfaceParticleSystem::writeTransforms(float *rows, float alpha, const std::vector<uint32_t> &indices) {
+    auto start = std::chrono::steady_clock::now();
+
+    SurfaceKernels::writeTransforms(m_Surface.frames, getArrays(), indices.data(), indices.size(), alpha, rows);
+
+    if (!indices.empty()) {
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        m_TransformNanoseconds = elapsed / static_cast<double>(indices.size());
+    }
+}
+
+glm::vec3 SurfaceParticleSystem::getCorner(uint32_t triangle, int k) const {
+    return m_Surface.cornerPosition(triangle, k);
+}
+
+glm::vec3 SurfaceParticleSystem::getTriangleNormal(uint32_t triangle) const {
+    return m_Surface.frames[triangle].normal;
+}
+
+size_t SurfaceParticleSystem::memoryUsage() const {
+    return m_Positions.memoryUsage() + m_PreviousPositions.memoryUsage() + m_Velocities.memoryUsage() +
+           m_Speeds.capacity() * sizeof(float) + m_Triangles.capacity() * sizeof(uint32_t) + m_Grid.memoryUsage() +
+           m_TriangleIndex.memoryUsage();
+}
+
+float SurfaceParticleSystem::bytesPerParticle() const {
+    if (size() == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(memoryUsage()) / static_cast<float>(size());
+}
+
+} // namespace Engine
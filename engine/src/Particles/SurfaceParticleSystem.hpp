@@ -0,0 +1,213 @@
+#pragma once
+
+#include "Frustum.hpp"
+#include "JobPool.hpp"
+#include "Mesh.hpp"
+#include "ParticleSnapshot.hpp"
+#include "SpatialHashGrid.hpp"
+#include "SurfaceKernels.hpp"
+#include "TriangleParticleIndex.hpp"
+#include "Vec3Array.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Particles walking over the surface of a triangle mesh. Particle state is
+ * kept in contiguous per-attribute arrays so that updates touch only the data
+ * they need.
+ */
+class SurfaceParticleSystem {
+  public:
+    struct Stats {
+        size_t crossings = 0;
+        size_t bounces = 0;
+    };
+
+  private:
+    Mesh &m_Surface;
+    size_t m_SurfaceListener;
+
+    Vec3Array m_Positions;
+    Vec3Array m_PreviousPositions;
+    Vec3Array m_Velocities;
+    std::vector<float> m_Speeds;
+    std::vector<uint32_t> m_Triangles;
+
+    float m_Speed = 0.3f;
+    SimdLevel m_SimdLevel;
+    size_t m_ChunkSize = 16384;
+    double m_TransformNanoseconds = 0.0;
+    uint64_t m_Seed;
+
+    float m_SeparationRadius = 0.0f;
+    float m_SeparationStrength = 1.0f;
+    size_t m_SortInterval = 32;
+    size_t m_StepsSinceSort = std::numeric_limits<size_t>::max();
+    SpatialHashGrid m_Grid;
+    TriangleParticleIndex m_TriangleIndex;
+
+    // One entry per job pool slot, so chunks never write the same counters.
+    std::vector<Stats> m_Stats;
+
+  public:
+    /**
+     * Follows edits committed on the surface: particles on changed triangles
+     * keep their barycentric location and heading, and a rebuilt surface
+     * respawns them.
+     */
+    explicit SurfaceParticleSystem(Mesh &surface);
+    ~SurfaceParticleSystem();
+
+    SurfaceParticleSystem(const SurfaceParticleSystem &) = delete;
+    SurfaceParticleSystem &operator=(const SurfaceParticleSystem &) = delete;
+
+    void spawn(size_t count);
+
+    /**
+     * Spawns in chunks on the pool; particle state is valid after
+     * jobs.wait() and identical to spawn(count) for the same seed.
+     */
+    void spawn(size_t count, JobPool &jobs);
+    void clear();
+    void update(float deltaSeconds);
+
+    /**
+     * Splits the update into chunks and submits them to the pool. Returns
+     * immediately; particle state is valid again after jobs.wait().
+     */
+    void update(float deltaSeconds, JobPool &jobs);
+
+    glm::mat4 getTransform(size_t index) const;
+
+    /**
+     * Writes every particle transform as a packed 3x4 row-major matrix
+     * (12 floats per particle), the layout Mesh::setInstances expects.
+     * Positions are interpolated between the last two updates by alpha.
+     */
+    void writeTransforms(float *rows, float alpha = 1.0f);
+    double getTransformNanoseconds() const { return m_TransformNanoseconds; }
+
+    /**
+     * Collects the particles whose bounding sphere of the given radius
+     * touches the frustum, which has to be in the surface mesh's space.
+     * Tests the latest positions: add the distance of one step to the radius
+     * when drawing interpolated positions.
+     */
+    size_t cull(const Frustum &frustum, float radius, std::vector<uint32_t> &visible) const;
+
+    // Writes only the listed particles, packed in list order.
+    void writeTransforms(float *rows, float alpha, const std::vector<uint32_t> &indices);
+
+    template <typename TConsumer> void forEachTransform(TConsumer consumer) const {
+        for (size_t i = 0; i < size(); i++) {
+            consumer(i, getTransform(i));
+        }
+    }
+
+    // Sets the speed of every current particle and of later spawns.
+    void setSpeed(float speed) {
+        m_Speed = speed;
+        std::fill(m_Speeds.begin(), m_Speeds.end(), speed);
+    }
+    float getSpeed() const { return m_Speed; }
+
+    void setSeed(uint64_t seed) { m_Seed = seed; }
+    uint64_t getSeed() const { return m_Seed; }
+
+    /**
+     * Checkpoints the particle arrays, speed, seed and sort schedule to a
+     * ParticleSnapshot file. The async version copies the arrays up front
+     * and writes on a background thread while updates go on.
+     */
+    bool saveSnapshot(const std::string &path) const;
+    std::future<bool> saveSnapshotAsync(const std::string &path) const;
+
+    /**
+     * Replaces every particle with a snapshot taken on a surface with the
+     * same vertex and triangle counts. The pool version copies the arrays
+     * in parallel and waits for those jobs only.
+     */
+    bool loadSnapshot(const std::string &path);
+    bool loadSnapshot(const std::string &path, JobPool &jobs);
+
+    /**
+     * Steers particles away from neighbours closer than radius, with a push
+     * that fades linearly to zero at the radius. The neighbour grid is built
+     * from the positions at the start of each update and chunks steer in
+     * parallel against that snapshot. A radius of 0 turns separation off.
+     *
+     * While separation is on, particles are re-sorted by sortBySpace() every
+     * getSortInterval() updates, so particle indices are not stable.
+     */
+    void setSeparation(float radius, float strength = 1.0f);
+    float getSeparationRadius() const { return m_SeparationRadius; }
+    float getSeparationStrength() const { return m_SeparationStrength; }
+    const SpatialHashGrid &getGrid() const { return m_Grid; }
+
+    /**
+     * Reorders the particle arrays into neighbour grid order, so particles
+     * close on the surface are also close in memory.
+     */
+    void sortBySpace();
+
+    void setSortInterval(size_t updates) { m_SortInterval = updates; }
+    size_t getSortInterval() const { return m_SortInterval; }
+
+    void setSimdLevel(SimdLevel level) { m_SimdLevel = level; }
+    SimdLevel getSimdLevel() const { return m_SimdLevel; }
+
+    void setChunkSize(size_t chunkSize) { m_ChunkSize = chunkSize; }
+    size_t getChunkSize() const { return m_ChunkSize; }
+
+    size_t size() const { return m_Triangles.size(); }
+    size_t memoryUsage() const;
+    float bytesPerParticle() const;
+
+    Stats getStats() const;
+    void resetStats() { m_Stats.assign(m_Stats.size(), Stats()); }
+
+    const Mesh &getSurface() const { return m_Surface; }
+    const Vec3Array &getPositions() const { return m_Positions; }
+    const Vec3Array &getPreviousPositions() const { return m_PreviousPositions; }
+    const Vec3Array &getVelocities() const { return m_Velocities; }
+    const std::vector<float> &getSpeeds() const { return m_Speeds; }
+    const std::vector<uint32_t> &getTriangles() const { return m_Triangles; }
+
+  private:
+    size_t grow(size_t count);
+    void spawnRange(size_t begin, size_t end);
+
+    SurfaceParticleArrays getArrays();
+    void addStats(unsigned slot, const SurfaceStepper::Result &result);
+
+    ParticleSnapshot::Header createSnapshotHeader() const;
+    std::vector<const void *> getSnapshotArrays() const;
+    bool openSnapshot(const std::string &path, ParticleSnapshot &snapshot) const;
+    bool restoreArray(const ParticleSnapshot &snapshot, size_t index);
+    bool finishRestore(const std::string &path, const ParticleSnapshot &snapshot, bool valid);
+
+    void onSurfaceChanged(const MeshChange &change);
+    void reproject(size_t index, const glm::vec3 *previousCorners);
+
+    void buildGrid();
+    void prepareSeparation();
+    void separateRange(size_t begin, size_t end, float deltaSeconds);
+
+    template <typename T> static void permute(std::vector<T> &values, const std::vector<uint32_t> &order);
+
+    glm::vec3 getCorner(uint32_t triangle, int k) const;
+    glm::vec3 getTriangleNormal(uint32_t triangle) const;
+};
+
+} // namespace Engine
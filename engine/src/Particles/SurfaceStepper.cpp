@@ -0,0 +1,78 @@
+#include "SurfaceStepper.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+
+namespace Engine {
+
+SurfaceStepper::Result SurfaceStepper::step(const MeshTopology &topology, const TriangleFrames &frames,
+                                            glm::vec3 &position, glm::vec3 &velocity, uint32_t &triangle,
+                                            float distance) {
+    Result result;
+    float remaining = distance;
+
+    for (int i = 0; i < c_MaxCrossings && remaining > 0.0f; i++) {
+        const TriangleFrame &frame = frames[triangle];
+
+        float time = remaining;
+        int exitEdge = findExitEdge(frame, position, velocity, time);
+
+        position += velocity * time;
+        remaining -= time;
+
+        if (exitEdge < 0) {
+            break;
+        }
+
+        int32_t next = topology.neighbor(triangle, exitEdge);
+        if (next == MeshTopology::c_NoNeighbor) {
+            velocity *= -1.0f;
+            result.bounces++;
+            continue;
+        }
+
+        velocity = unfold(frame, exitEdge, frames[next], topology.neighborEdge(triangle, exitEdge), velocity);
+        triangle = static_cast<uint32_t>(next);
+        result.crossings++;
+    }
+
+    return result;
+}
+
+int SurfaceStepper::findExitEdge(const TriangleFrame &frame, glm::vec3 position, glm::vec3 velocity, float &time) {
+    int exitEdge = -1;
+
+    for (int edge = 0; edge < 3; edge++) {
+        float rate = glm::dot(frame.edgeNormals[edge], velocity);
+        if (rate >= 0.0f) {
+            continue;
+        }
+
+        float gap = std::max(glm::dot(frame.edgeNormals[edge], position) - frame.edgeOffsets[edge], 0.0f);
+        float edgeTime = gap / -rate;
+
+        if (edgeTime < time) {
+            time = edgeTime;
+            exitEdge = edge;
+        }
+    }
+
+    return exitEdge;
+}
+
+glm::vec3 SurfaceStepper::unfold(const TriangleFrame &from, int fromEdge, const TriangleFrame &to, int toEdge,
+                                 glm::vec3 velocity) {
+    // Keep the component along the shared edge and turn the outgoing
+    // component into the inward direction of the neighbour.
+    glm::vec3 edgeDir = glm::cross(from.edgeNormals[fromEdge], from.normal);
+    float along = glm::dot(velocity, edgeDir);
+    float across = -glm::dot(velocity, from.edgeNormals[fromEdge]);
+
+    glm::vec3 unfolded = edgeDir * along + to.edgeNormals[toEdge] * across;
+    float length = glm::length(unfolded);
+
+    return length > 0.0f ? unfolded / length : velocity;
+}
+
+} // namespace Engine
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "MeshTopology.hpp"
+#include "TriangleFrames.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+
+namespace Engine {
+
+/**
+ * Moves a point along a triangle mesh surface. The point travels in a straight
+ * line inside its triangle until it reaches the exact exit edge, then the
+ * velocity is unfolded onto the neighbouring triangle and the remaining
+ * distance is walked there, as many times as the step requires.
+ */
+class SurfaceStepper {
+  public:
+    static constexpr int c_MaxCrossings = 32;
+
+    struct Result {
+        uint32_t crossings = 0;
+        uint32_t bounces = 0;
+    };
+
+    static Result step(const MeshTopology &topology, const TriangleFrames &frames, glm::vec3 &position,
+                       glm::vec3 &velocity, uint32_t &triangle, float distance);
+
+    static int findExitEdge(const TriangleFrame &frame, glm::vec3 position, glm::vec3 velocity, float &time);
+
+    static glm::vec3 unfold(const TriangleFrame &from, int fromEdge, const TriangleFrame &to, int toEdge,
+                            glm::vec3 velocity);
+};
+
+} // namespace Engine
@@ -0,0 +1,50 @@
+#include "TriangleParticleIndex.hpp"
+
+namespace Engine {
+
+bool TriangleParticleIndex::prepare(const std::vector<uint32_t> &triangles, size_t triangleCount) {
+    if (m_Valid && m_Starts.size() == triangleCount + 1) {
+        return true;
+    }
+    if (!m_Requested) {
+        m_Requested = true;
+        return false;
+    }
+
+    build(triangles, triangleCount);
+    return true;
+}
+
+void TriangleParticleIndex::build(const std::vector<uint32_t> &triangles, size_t triangleCount) {
+    m_Starts.assign(triangleCount + 1, 0);
+    for (uint32_t triangle : triangles) {
+        if (triangle < triangleCount) {
+            m_Starts[triangle + 1]++;
+        }
+    }
+    for (size_t t = 0; t < triangleCount; t++) {
+        m_Starts[t + 1] += m_Starts[t];
+    }
+
+    // Fills in particle order, so each triangle lists its particles ascending.
+    m_Particles.resize(m_Starts[triangleCount]);
+    std::vector<uint32_t> fill(m_Starts.begin(), m_Starts.end() - 1);
+    for (size_t i = 0; i < triangles.size(); i++) {
+        if (triangles[i] < triangleCount) {
+            m_Particles[fill[triangles[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+    m_Valid = true;
+}
+
+void TriangleParticleIndex::clear() {
+    m_Starts.clear();
+    m_Particles.clear();
+    invalidate();
+}
+
+size_t TriangleParticleIndex::memoryUsage() const {
+    return m_Starts.capacity() * sizeof(uint32_t) + m_Particles.capacity() * sizeof(uint32_t);
+}
+
+} // namespace Engine
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Particles grouped by the triangle they are on, so a surface edit visits
+ * only the particles on the edited triangles. Invalidated whenever the
+ * particle triangle ids are written. Building costs about as much as one
+ * scan over the particles, so it is only built for the second edit between
+ * two updates; the first one is served by a scan.
+ */
+class TriangleParticleIndex {
+  private:
+    // Particles on triangle t are m_Particles[m_Starts[t]] up to m_Starts[t + 1].
+    std::vector<uint32_t> m_Starts;
+    std::vector<uint32_t> m_Particles;
+    bool m_Valid = false;
+    bool m_Requested = false;
+
+  public:
+    void invalidate() {
+        m_Valid = false;
+        m_Requested = false;
+    }
+    bool valid() const { return m_Valid; }
+
+    /**
+     * Returns whether forEachOn() can be used. A stale index is rebuilt from
+     * the triangle id of every particle when it was already requested since
+     * it went stale; otherwise the caller scans the particles itself.
+     */
+    bool prepare(const std::vector<uint32_t> &triangles, size_t triangleCount);
+    void build(const std::vector<uint32_t> &triangles, size_t triangleCount);
+    void clear();
+
+    template <typename TVisitor> void forEachOn(uint32_t triangle, TVisitor visitor) const {
+        if (static_cast<size_t>(triangle) + 1 >= m_Starts.size()) {
+            return;
+        }
+        for (uint32_t i = m_Starts[triangle]; i < m_Starts[triangle + 1]; i++) {
+            visitor(m_Particles[i]);
+        }
+    }
+
+    size_t memoryUsage() const;
+};
+
+} // namespace Engine
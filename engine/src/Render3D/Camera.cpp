@@ -16,9 +16,33 @@ Camera::Camera(glm::vec3 position, glm::vec3 up, glm::vec3 front)
 
 Camera::~Camera() {}
 
-glm::mat4 Camera::viewMatrix() const { return glm::lookAt(position, position + front, up); }
+const glm::mat4 &Camera::viewMatrix() const {
+    updateCache();
+    return view;
+}
+
+const glm::mat4 &Camera::projectionMatrix() const { return mode == Projection::PERSPECTIVE ? perspective : orthogonal; }
+
+const glm::mat4 &Camera::viewProjectionMatrix() const {
+    updateCache();
+    return viewProjection;
+}
+
+const Frustum &Camera::frustum() const {
+    updateCache();
+    return viewFrustum;
+}
+
+void Camera::updateCache() const {
+    if (!dirty) {
+        return;
+    }
 
-glm::mat4 Camera::projectionMatrix() const { return mode == Projection::PERSPECTIVE ? perspective : orthogonal; }
+    view = glm::lookAt(position, position + front, up);
+    viewProjection = projectionMatrix() * view;
+    viewFrustum = Frustum::fromMatrix(viewProjection);
+    dirty = false;
+}
 
 glm::mat4 Camera::orthogonalMatrix() const { return orthogonal; }
 
@@ -46,6 +70,7 @@ void Camera::setPerspective(float fieldOfView, float zNear, float zFar) {
     float aspect = static_cast<float>(width) / static_cast<float>(height);
 
     perspective = glm::perspective(fieldOfView, aspect, zNear, zFar);
+    dirty = true;
 }
 
 void Camera::setFieldOfView(float fieldOfView) { setPerspective(fieldOfView, zNear, zFar); }
@@ -62,25 +87,35 @@ void Camera::setOrthogonal(float zNear, float zFar, float zoom) {
     float widthHalf = (1.0f / zoom) * distance * aspect;
     float heightHalf = (1.0f / zoom) * distance;
     orthogonal = glm::ortho(-widthHalf, widthHalf, -heightHalf, heightHalf, zNear, zFar);
+    dirty = true;
 }
 
-void Camera::setProjection(Projection mode) { this->mode = mode; }
+void Camera::setProjection(Projection mode) {
+    this->mode = mode;
+    dirty = true;
+}
 
-void Camera::setPosition(glm::vec3 position) { this->position = position; }
+void Camera::setPosition(glm::vec3 position) {
+    this->position = position;
+    dirty = true;
+}
 
 void Camera::setRotation(glm::quat rotation) {
     this->rotation = rotation;
     this->front = glm::normalize((this->rotation * glm::vec3(0.0f, 0.0f, -1.0f)));
+    dirty = true;
 }
 
 void Camera::move(const glm::vec3 &offset) {
     position += front * offset.z;
     position += up * offset.y;
     position += glm::normalize(glm::cross(front, up)) * offset.x;
+    dirty = true;
 }
 
 void Camera::inversePitch() {
     this->front = glm::reflect(this->front, this->up);
+    dirty = true;
 }
 
 glm::vec3 Camera::frontVec() const { return front; }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Frustum.hpp"
+
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <glm/mat4x4.hpp>
@@ -17,8 +19,11 @@ class Camera {
     void move(const glm::vec3 &offset);
     void rotate(const glm::quat &delta);
 
-    glm::mat4 viewMatrix() const;
-    glm::mat4 projectionMatrix() const;
+    // View, view-projection and frustum are cached and rebuilt on first use after a change.
+    const glm::mat4 &viewMatrix() const;
+    const glm::mat4 &projectionMatrix() const;
+    const glm::mat4 &viewProjectionMatrix() const;
+    const Frustum &frustum() const;
     glm::mat4 orthogonalMatrix() const;
     glm::vec3 positionVec() const;
     glm::vec3 upVec() const;
@@ -58,6 +63,13 @@ class Camera {
 
     float fieldOfView, zNear, zFar;
     float zoom = 1.0f;
+
+    mutable glm::mat4 view;
+    mutable glm::mat4 viewProjection;
+    mutable Frustum viewFrustum;
+    mutable bool dirty = true;
+
+    void updateCache() const;
 };
 
 } // namespace Engine
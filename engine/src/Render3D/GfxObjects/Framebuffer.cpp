@@ -1,6 +1,7 @@
 #include "Framebuffer.hpp"
 
 #include "GfxUtils.hpp"
+#include "GpuResources.hpp"
 
 #include "glad/glad.h"
 
@@ -21,7 +22,7 @@ Framebuffer Framebuffer::createDefault() {
 Framebuffer Framebuffer::create() {
     Framebuffer framebuffer;
 
-    glGenFramebuffers(1, &framebuffer.id);
+    framebuffer.id = GpuResources::create(GpuResources::Framebuffer);
 
     return framebuffer;
 }
@@ -41,7 +42,7 @@ void Framebuffer::resize(unsigned int width, unsigned int height) {
 
 void Framebuffer::free() {
     if (!empty()) {
-        glDeleteFramebuffers(1, &id);
+        GpuResources::release(GpuResources::Framebuffer, id);
         setEmpty();
 
         for (unsigned int index = 0; index < m_AttachmentsIndex; index++) {
@@ -153,12 +154,12 @@ void Framebuffer::Attachment::free() {
     }
 
     if (m_Type == Attachment::Type::Texture) {
-        glDeleteTextures(1, &id);
+        GpuResources::release(GpuResources::Texture, id);
         setEmpty();
     }
 
     if (m_Type == Attachment::Type::Renderbuffer) {
-        glDeleteRenderbuffers(1, &id);
+        GpuResources::release(GpuResources::Renderbuffer, id);
         setEmpty();
     }
 }
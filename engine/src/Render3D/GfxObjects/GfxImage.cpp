@@ -158,4 +158,35 @@ GfxImage::DataFormat GfxImage::formatToDataFormat(InternalFormat format) {
     }
 }
 
+size_t GfxImage::getTexelBytes(InternalFormat format) {
+    switch (format) {
+    case InternalFormat::R8F:
+    case InternalFormat::R8I:
+        return 1;
+    case InternalFormat::R16I:
+    case InternalFormat::R16F:
+        return 2;
+    case InternalFormat::RGB8F:
+    case InternalFormat::RGB8I:
+        return 3;
+    case InternalFormat::DEPTH_COMPONENT:
+    case InternalFormat::DEPTH_STENCIL:
+    case InternalFormat::R32F:
+    case InternalFormat::R32I:
+    case InternalFormat::RGBA8:
+    case InternalFormat::RGBA8F:
+        return 4;
+    case InternalFormat::RGB16F:
+        return 6;
+    case InternalFormat::RGBA16F:
+        return 8;
+    case InternalFormat::RGB32F:
+        return 12;
+    case InternalFormat::RGBA32F:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
 } // namespace Engine
\ No newline at end of file
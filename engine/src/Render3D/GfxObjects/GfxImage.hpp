@@ -2,6 +2,8 @@
 
 #include "GfxObject.hpp"
 
+#include <cstddef>
+
 namespace Engine {
 
 class GfxImage : public GfxObject {
@@ -49,6 +51,7 @@ class GfxImage : public GfxObject {
     static unsigned int getNativeFormat(InternalFormat format);
     static DataType formatToDataType(InternalFormat format);
     static DataFormat formatToDataFormat(InternalFormat format);
+    static size_t getTexelBytes(InternalFormat format);
 };
 
 } // namespace Engine
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "GpuResources.hpp"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+
+namespace Engine {
+
+namespace {
+
+struct GpuObject {
+    size_t references = 0;
+    size_t bytes = 0;
+};
+
+struct GpuRegistry {
+    std::unordered_map<uint64_t, GpuObject> objects;
+    GpuResources::Totals totals[GpuResources::KindCount];
+};
+
+// Built on first use, so objects created during static initialization are counted too.
+GpuRegistry &registry() {
+    static GpuRegistry instance;
+    return instance;
+}
+
+uint64_t objectKey(GpuResources::Kind kind, GfxObjectId id) { return (static_cast<uint64_t>(kind) << 32) | id; }
+
+void deleteObject(GpuResources::Kind kind, GfxObjectId id) {
+    switch (kind) {
+    case GpuResources::VertexArray:
+        glDeleteVertexArrays(1, &id);
+        break;
+    case GpuResources::Buffer:
+        glDeleteBuffers(1, &id);
+        break;
+    case GpuResources::Texture:
+        glDeleteTextures(1, &id);
+        break;
+    case GpuResources::Framebuffer:
+        glDeleteFramebuffers(1, &id);
+        break;
+    case GpuResources::Renderbuffer:
+        glDeleteRenderbuffers(1, &id);
+        break;
+    default:
+        break;
+    }
+}
+
+} // namespace
+
+GfxObjectId GpuResources::create(Kind kind) {
+    GfxObjectId id = c_NoGfxObjectId;
+    switch (kind) {
+    case VertexArray:
+        glGenVertexArrays(1, &id);
+        break;
+    case Buffer:
+        glGenBuffers(1, &id);
+        break;
+    case Texture:
+        glGenTextures(1, &id);
+        break;
+    case Framebuffer:
+        glGenFramebuffers(1, &id);
+        break;
+    case Renderbuffer:
+        glGenRenderbuffers(1, &id);
+        break;
+    default:
+        break;
+    }
+    if (id == c_NoGfxObjectId) {
+        return id;
+    }
+
+    GpuRegistry &gpu = registry();
+    gpu.objects[objectKey(kind, id)].references = 1;
+    gpu.totals[kind].objects++;
+    gpu.totals[kind].created++;
+    return id;
+}
+
+void GpuResources::retain(Kind kind, GfxObjectId id) {
+    auto object = registry().objects.find(objectKey(kind, id));
+    if (object != registry().objects.end()) {
+        object->second.references++;
+    }
+}
+
+void GpuResources::release(Kind kind, GfxObjectId id) {
+    if (id == c_NoGfxObjectId) {
+        return;
+    }
+
+    GpuRegistry &gpu = registry();
+    auto object = gpu.objects.find(objectKey(kind, id));
+    if (object == gpu.objects.end()) {
+        deleteObject(kind, id);
+        return;
+    }
+    if (--object->second.references > 0) {
+        return;
+    }
+
+    Totals &totals = gpu.totals[kind];
+    totals.bytes -= object->second.bytes;
+    totals.objects--;
+    totals.deleted++;
+    gpu.objects.erase(object);
+    deleteObject(kind, id);
+}
+
+void GpuResources::setBytes(Kind kind, GfxObjectId id, size_t bytes) {
+    GpuRegistry &gpu = registry();
+    auto object = gpu.objects.find(objectKey(kind, id));
+    if (object == gpu.objects.end()) {
+        return;
+    }
+
+    Totals &totals = gpu.totals[kind];
+    totals.bytes = totals.bytes - object->second.bytes + bytes;
+    totals.peakBytes = std::max(totals.peakBytes, totals.bytes);
+    object->second.bytes = bytes;
+}
+
+size_t GpuResources::getBytes(Kind kind, GfxObjectId id) {
+    auto object = registry().objects.find(objectKey(kind, id));
+    return object != registry().objects.end() ? object->second.bytes : 0;
+}
+
+size_t GpuResources::getReferences(Kind kind, GfxObjectId id) {
+    auto object = registry().objects.find(objectKey(kind, id));
+    return object != registry().objects.end() ? object->second.references : 0;
+}
+
+GpuResources::Totals GpuResources::getTotals(Kind kind) { return registry().totals[kind]; }
+
+const char *GpuResources::getName(Kind kind) {
+    switch (kind) {
+    case VertexArray:
+        return "vertex array";
+    case Buffer:
+        return "buffer";
+    case Texture:
+        return "texture";
+    case Framebuffer:
+        return "framebuffer";
+    case Renderbuffer:
+        return "renderbuffer";
+    default:
+        return "unknown";
+    }
+}
+
+size_t GpuResources::reportLeaks() {
+    size_t leaks = 0;
+    for (int kind = 0; kind < KindCount; kind++) {
+        const Totals &totals = registry().totals[kind];
+        if (totals.objects > 0) {
+            std::cerr << "GpuResources: " << totals.objects << " " << getName(static_cast<Kind>(kind))
+                      << " objects still alive, " << totals.bytes << " bytes\n";
+        }
+        leaks += totals.objects;
+    }
+    return leaks;
+}
+
+GpuHandle::GpuHandle(const GpuHandle &other) : m_Kind(other.m_Kind), m_Id(other.m_Id) {
+    GpuResources::retain(m_Kind, m_Id);
+}
+
+GpuHandle::GpuHandle(GpuHandle &&other) noexcept : m_Kind(other.m_Kind), m_Id(other.m_Id) {
+    other.m_Id = c_NoGfxObjectId;
+}
+
+GpuHandle &GpuHandle::operator=(GpuHandle other) noexcept {
+    std::swap(m_Kind, other.m_Kind);
+    std::swap(m_Id, other.m_Id);
+    return *this;
+}
+
+GpuHandle GpuHandle::create(GpuResources::Kind kind) {
+    GpuHandle handle;
+    handle.m_Kind = kind;
+    handle.m_Id = GpuResources::create(kind);
+    return handle;
+}
+
+void GpuHandle::reset() {
+    GpuResources::release(m_Kind, m_Id);
+    m_Id = c_NoGfxObjectId;
+}
+
+} // namespace Engine
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "GfxObject.hpp"
+
+#include <cstddef>
+
+namespace Engine {
+
+/**
+ * Registry of the GL objects the engine creates, counted per kind. Objects
+ * are reference counted and deleted when the last reference is released;
+ * owners report the bytes of storage they specify, so the totals show GPU
+ * memory per kind. Whatever is still alive when the context goes is a leak.
+ *
+ * GL objects belong to the context thread, and so does the registry.
+ */
+class GpuResources {
+  public:
+    enum Kind { VertexArray, Buffer, Texture, Framebuffer, Renderbuffer, KindCount };
+
+    struct Totals {
+        size_t objects = 0;
+        size_t bytes = 0;
+        size_t peakBytes = 0;
+        size_t created = 0;
+        size_t deleted = 0;
+    };
+
+    // Generates an object with one reference.
+    static GfxObjectId create(Kind kind);
+
+    static void retain(Kind kind, GfxObjectId id);
+
+    // Deletes the object with its last reference. Ids the registry never saw are deleted right away.
+    static void release(Kind kind, GfxObjectId id);
+
+    static void setBytes(Kind kind, GfxObjectId id, size_t bytes);
+    static size_t getBytes(Kind kind, GfxObjectId id);
+    // 0 for ids the registry does not know.
+    static size_t getReferences(Kind kind, GfxObjectId id);
+
+    static Totals getTotals(Kind kind);
+    static const char *getName(Kind kind);
+
+    // Prints every kind with objects still alive to std::cerr; returns how many there are.
+    static size_t reportLeaks();
+};
+
+/**
+ * One reference to a registered GL object: copies share it and the last one
+ * to go deletes it. Empty handles hold no object and make no GL calls.
+ */
+class GpuHandle {
+  private:
+    GpuResources::Kind m_Kind = GpuResources::Buffer;
+    GfxObjectId m_Id = c_NoGfxObjectId;
+
+  public:
+    GpuHandle() = default;
+    GpuHandle(const GpuHandle &other);
+    GpuHandle(GpuHandle &&other) noexcept;
+    GpuHandle &operator=(GpuHandle other) noexcept;
+    ~GpuHandle() { reset(); }
+
+    static GpuHandle create(GpuResources::Kind kind);
+
+    GfxObjectId get() const { return m_Id; }
+    bool empty() const { return m_Id == c_NoGfxObjectId; }
+    explicit operator bool() const { return !empty(); }
+
+    void setBytes(size_t bytes) const { GpuResources::setBytes(m_Kind, m_Id, bytes); }
+    size_t getBytes() const { return GpuResources::getBytes(m_Kind, m_Id); }
+    // True while another handle refers to the same object.
+    bool shared() const { return GpuResources::getReferences(m_Kind, m_Id) > 1; }
+
+    void reset();
+};
+
+} // namespace Engine
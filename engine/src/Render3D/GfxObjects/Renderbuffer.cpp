@@ -1,5 +1,7 @@
 #include "Renderbuffer.hpp"
 
+#include "GpuResources.hpp"
+
 #include "glad/glad.h"
 
 #include <iostream>
@@ -14,10 +16,12 @@ Renderbuffer Renderbuffer::create(unsigned int width, unsigned int height, Inter
     renderbuffer.height = height;
     renderbuffer.format = format;
 
-    glGenRenderbuffers(1, &renderbuffer.id);
+    renderbuffer.id = GpuResources::create(GpuResources::Renderbuffer);
     glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer.id);
     glRenderbufferStorage(GL_RENDERBUFFER, GfxImage::getNativeFormat(format), width, height);
     glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    GpuResources::setBytes(GpuResources::Renderbuffer, renderbuffer.id,
+                           static_cast<size_t>(width) * height * GfxImage::getTexelBytes(format));
 
     return renderbuffer;
 }
@@ -28,7 +32,7 @@ void Renderbuffer::unbind() const { glBindRenderbuffer(GL_RENDERBUFFER, 0); }
 
 void Renderbuffer::free() {
     if (!empty()) {
-        glDeleteRenderbuffers(1, &id);
+        GpuResources::release(GpuResources::Renderbuffer, id);
         setEmpty();
     }
 }
@@ -38,6 +42,7 @@ void Renderbuffer::resize(unsigned int width, unsigned int height) {
     this->height = height;
 
     glRenderbufferStorage(GL_RENDERBUFFER, GfxImage::getNativeFormat(format), width, height);
+    GpuResources::setBytes(GpuResources::Renderbuffer, id, static_cast<size_t>(width) * height * getTexelBytes(format));
 }
 
 } // namespace Engine
\ No newline at end of file
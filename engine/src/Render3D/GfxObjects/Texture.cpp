@@ -1,5 +1,7 @@
 #include "Texture.hpp"
 
+#include "GpuResources.hpp"
+
 #include "glad/glad.h"
 
 #include <stdexcept>
@@ -29,15 +31,21 @@ void Texture::resize(unsigned int width, unsigned int height) {
 
     glTexImage2D(getGLTextureType(type), 0, GfxImage::getNativeFormat(format), width, height, 0,
                  GfxImage::getNativeDataFormat(dataFormat), GfxImage::getNativeDataType(dataType), NULL);
+    GpuResources::setBytes(GpuResources::Texture, id, getBytes());
 }
 
 void Texture::free() {
     if (!empty()) {
-        glDeleteTextures(1, &id);
+        GpuResources::release(GpuResources::Texture, id);
         setEmpty();
     }
 }
 
+size_t Texture::getBytes() const {
+    size_t layers = type == TextureType::CUBE_MAP ? 6 : 1;
+    return static_cast<size_t>(width) * height * GfxImage::getTexelBytes(format) * layers;
+}
+
 Texture Texture::getEmpty() {
     Texture texture;
     texture.setEmpty();
@@ -49,7 +57,7 @@ Texture Texture::createDepthBuffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
@@ -68,6 +76,7 @@ Texture Texture::createDepthBuffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::DEPTH_COMPONENT;
     texture.dataType = Texture::DataType::FLOAT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -76,7 +85,7 @@ CubeMapTexture CubeMapTexture::createCubeDepthBuffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_CUBE_MAP, texture.id);
 
     for (unsigned int i = 0; i < 6; i++) {
@@ -97,6 +106,7 @@ CubeMapTexture CubeMapTexture::createCubeDepthBuffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::DEPTH_COMPONENT;
     texture.dataType = Texture::DataType::FLOAT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -105,7 +115,7 @@ CubeMapTexture CubeMapTexture::createCubeMap() {
     texture.width = 0;
     texture.height = 0;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_CUBE_MAP, texture.id);
 
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -119,6 +129,7 @@ CubeMapTexture CubeMapTexture::createCubeMap() {
     texture.type = Texture::TextureType::CUBE_MAP;
     texture.dataType = Texture::DataType::UNSIGNED_BYTE;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -127,7 +138,7 @@ Texture Texture::createRGBA8FBuffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
@@ -144,6 +155,7 @@ Texture Texture::createRGBA8FBuffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::RGBA;
     texture.dataType = Texture::DataType::FLOAT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -152,7 +164,7 @@ Texture Texture::createRGBA16FBuffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
@@ -169,6 +181,7 @@ Texture Texture::createRGBA16FBuffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::RGBA;
     texture.dataType = Texture::DataType::FLOAT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -177,7 +190,7 @@ Texture Texture::createRGBA32FBuffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
@@ -194,6 +207,7 @@ Texture Texture::createRGBA32FBuffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::RGBA;
     texture.dataType = Texture::DataType::FLOAT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -202,7 +216,7 @@ Texture Texture::createRGB8FBuffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_FLOAT, NULL);
@@ -219,6 +233,7 @@ Texture Texture::createRGB8FBuffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::RGB;
     texture.dataType = Texture::DataType::FLOAT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -227,7 +242,7 @@ Texture Texture::createRGB16FBuffer(int width, int height, void *data) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, data);
@@ -244,6 +259,7 @@ Texture Texture::createRGB16FBuffer(int width, int height, void *data) {
     texture.dataFormat = Texture::DataFormat::RGB;
     texture.dataType = Texture::DataType::FLOAT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -252,7 +268,7 @@ Texture Texture::createRGB32FBuffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, width, height, 0, GL_RGB, GL_FLOAT, NULL);
@@ -269,6 +285,7 @@ Texture Texture::createRGB32FBuffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::RGB;
     texture.dataType = Texture::DataType::FLOAT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -277,7 +294,7 @@ Texture Texture::createRGB8IBuffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8I, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
@@ -294,6 +311,7 @@ Texture Texture::createRGB8IBuffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::RGB;
     texture.dataType = Texture::DataType::UNSIGNED_BYTE;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -302,7 +320,7 @@ Texture Texture::createRGBA8Buffer(int width, int height, void *data) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
@@ -317,6 +335,7 @@ Texture Texture::createRGBA8Buffer(int width, int height, void *data) {
     texture.dataFormat = Texture::DataFormat::RGBA;
     texture.dataType = Texture::DataType::UNSIGNED_BYTE;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -325,7 +344,7 @@ Texture Texture::createR32IBuffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_R32I, width, height, 0, GL_RED_INTEGER, GL_INT, NULL);
@@ -343,6 +362,7 @@ Texture Texture::createR32IBuffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::RED_INTEGER;
     texture.dataType = Texture::DataType::INT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -351,7 +371,7 @@ Texture Texture::createR8Buffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_FLOAT, NULL);
@@ -369,6 +389,7 @@ Texture Texture::createR8Buffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::RED;
     texture.dataType = Texture::DataType::FLOAT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -377,7 +398,7 @@ Texture Texture::createR16FBuffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, width, height, 0, GL_RED, GL_FLOAT, NULL);
@@ -395,6 +416,7 @@ Texture Texture::createR16FBuffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::RED;
     texture.dataType = Texture::DataType::FLOAT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -403,7 +425,7 @@ Texture Texture::createR32FBuffer(int width, int height) {
     texture.width = width;
     texture.height = height;
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, NULL);
@@ -421,6 +443,7 @@ Texture Texture::createR32FBuffer(int width, int height) {
     texture.dataFormat = Texture::DataFormat::RED;
     texture.dataType = Texture::DataType::FLOAT;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -431,7 +454,7 @@ Texture Texture::createTrueTypeGlyph(int width, int height, unsigned char *data)
 
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, data);
@@ -450,6 +473,7 @@ Texture Texture::createTrueTypeGlyph(int width, int height, unsigned char *data)
     texture.dataFormat = Texture::DataFormat::RED;
     texture.dataType = Texture::DataType::UNSIGNED_BYTE;
 
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes());
     return texture;
 }
 
@@ -2,6 +2,7 @@
 
 #include "GfxImage.hpp"
 
+#include <cstddef>
 #include <string>
 
 namespace Engine {
@@ -20,6 +21,9 @@ class Texture : public GfxImage {
 
     void resize(unsigned int width, unsigned int height) override;
 
+    // Storage of the base level, all faces of a cube map
+    size_t getBytes() const;
+
     static Texture getEmpty();
 
     static Texture createDepthBuffer(int width, int height);
@@ -0,0 +1,282 @@
+#include "MeshCache.hpp"
+
+#include "AtomicFileWriter.hpp"
+#include "Frustum.hpp"
+#include "VertexIndexer.hpp"
+
+#include <cstring>
+#include <iostream>
+
+namespace Engine {
+
+namespace {
+
+const char c_CacheMagic[8] = {'M', 'E', 'S', 'H', 'C', 'A', 'C', 'H'};
+const uint32_t c_CacheByteOrder = 0x01020304u;
+
+size_t alignSection(size_t offset) { return (offset + MeshCache::c_Alignment - 1) & ~(MeshCache::c_Alignment - 1); }
+
+bool cacheError(const std::string &path, const char *reason) {
+    std::cerr << "MeshCache: " << path << ": " << reason << "\n";
+    return false;
+}
+
+// 64-bit multiply-xorshift over 8 byte words; only has to notice edits, not resist attacks.
+uint64_t hashBytes(const char *data, size_t size) {
+    uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+    size_t words = size / 8;
+
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word;
+        std::memcpy(&word, data + i * 8, sizeof(word));
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 32;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + words * 8, size - words * 8);
+    hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+    return hash ^ (hash >> 29);
+}
+
+template <typename T> bool allBelow(const std::vector<T> &values, size_t limit) {
+    for (T value : values) {
+        if (static_cast<size_t>(value) >= limit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T> const T *sectionData(const MeshCache &cache, MeshCache::Section section) {
+    return static_cast<const T *>(cache.section(section));
+}
+
+} // namespace
+
+bool MeshCache::describe(const std::string &path, Source &source) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    file.adviseSequential();
+
+    source.bytes = file.size();
+    source.hash = hashBytes(file.data(), file.size());
+    return true;
+}
+
+bool MeshCache::write(const std::string &path, const Source &source, const Mesh &mesh) {
+    const MeshTopology &topology = mesh.topology;
+    const TriangleFrames &frames = mesh.frames;
+    if (topology.empty() || frames.size() != topology.triangleCount()) {
+        return cacheError(path, "mesh has no topology or frames to cache");
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, c_CacheMagic, sizeof(c_CacheMagic));
+    header.version = c_Version;
+    header.byteOrder = c_CacheByteOrder;
+    header.headerBytes = sizeof(Header);
+    header.sectionCount = SectionCount;
+    header.vertexBytes = sizeof(Vertex);
+    header.frameBytes = sizeof(TriangleFrame);
+    header.basisBytes = sizeof(TriangleBasis);
+    header.indexBytes = static_cast<uint32_t>(VertexIndexer::indexBytes(mesh.vertices.size()));
+    header.sourceBytes = source.bytes;
+    header.sourceHash = source.hash;
+    header.vertexCount = mesh.vertices.size();
+    header.indexCount = mesh.indices.size();
+    header.triangleCount = topology.triangleCount();
+    header.weldedVertexCount = topology.weldedVertexCount;
+
+    BoundingBox bounds = BoundingBox::fromVertices(mesh.vertices);
+    std::memcpy(header.boundsMin, &bounds.min, sizeof(header.boundsMin));
+    std::memcpy(header.boundsMax, &bounds.max, sizeof(header.boundsMax));
+
+    // Indices go in the width the element buffer uses.
+    std::vector<uint16_t> shortIndices;
+    const void *indexData = mesh.indices.data();
+    if (header.indexBytes == sizeof(uint16_t)) {
+        shortIndices.assign(mesh.indices.begin(), mesh.indices.end());
+        indexData = shortIndices.data();
+    }
+
+    const void *data[SectionCount] = {mesh.vertices.data(),
+                                      indexData,
+                                      topology.weldedVertices.data(),
+                                      topology.neighbors.data(),
+                                      topology.neighborEdges.data(),
+                                      topology.boundaryMask.data(),
+                                      topology.vertexTriangleStarts.data(),
+                                      topology.vertexTriangles.data(),
+                                      frames.frames.data(),
+                                      frames.bases.data()};
+    header.sectionBytes[Vertices] = header.vertexCount * sizeof(Vertex);
+    header.sectionBytes[Indices] = header.indexCount * header.indexBytes;
+    header.sectionBytes[WeldedVertices] = topology.weldedVertices.size() * sizeof(uint32_t);
+    header.sectionBytes[Neighbors] = topology.neighbors.size() * sizeof(int32_t);
+    header.sectionBytes[NeighborEdges] = topology.neighborEdges.size();
+    header.sectionBytes[BoundaryMask] = topology.boundaryMask.size();
+    header.sectionBytes[VertexTriangleStarts] = topology.vertexTriangleStarts.size() * sizeof(uint32_t);
+    header.sectionBytes[VertexTriangles] = topology.vertexTriangles.size() * sizeof(uint32_t);
+    header.sectionBytes[Frames] = frames.frames.size() * sizeof(TriangleFrame);
+    header.sectionBytes[Bases] = frames.bases.size() * sizeof(TriangleBasis);
+
+    size_t offset = alignSection(sizeof(Header));
+    for (size_t i = 0; i < SectionCount; i++) {
+        header.sectionOffsets[i] = offset;
+        offset = alignSection(offset + header.sectionBytes[i]);
+    }
+
+    AtomicFileWriter out;
+    if (!out.open(path)) {
+        return cacheError(path, "cannot create a temporary file next to it");
+    }
+
+    offset = sizeof(Header);
+    out.write(&header, sizeof(Header));
+
+    for (size_t i = 0; i < SectionCount; i++) {
+        out.writeZeros(header.sectionOffsets[i] - offset);
+        out.write(data[i], header.sectionBytes[i]);
+        offset = header.sectionOffsets[i] + header.sectionBytes[i];
+    }
+
+    if (!out.commit()) {
+        return cacheError(path, "write failed");
+    }
+    return true;
+}
+
+bool MeshCache::open(const std::string &path, const Source &source) {
+    close();
+
+    if (!m_File.open(path)) {
+        return false;
+    }
+    if (m_File.size() < sizeof(Header)) {
+        close();
+        return cacheError(path, "too small for a cache header");
+    }
+
+    const Header *header = reinterpret_cast<const Header *>(m_File.data());
+    if (std::memcmp(header->magic, c_CacheMagic, sizeof(c_CacheMagic)) != 0) {
+        close();
+        return cacheError(path, "not a mesh cache");
+    }
+
+    // Stale: written by another version or for another source file.
+    if (header->version != c_Version || header->byteOrder != c_CacheByteOrder ||
+        header->headerBytes != sizeof(Header) || header->sectionCount != SectionCount ||
+        header->vertexBytes != sizeof(Vertex) || header->frameBytes != sizeof(TriangleFrame) ||
+        header->basisBytes != sizeof(TriangleBasis) || header->sourceBytes != source.bytes ||
+        header->sourceHash != source.hash) {
+        close();
+        return false;
+    }
+
+    uint64_t vertices = header->vertexCount;
+    uint64_t triangles = header->triangleCount;
+    uint64_t corners = header->indexCount > 0 ? header->indexCount : vertices;
+    if (vertices > m_File.size() || corners != triangles * 3 ||
+        header->indexBytes != VertexIndexer::indexBytes(vertices)) {
+        close();
+        return cacheError(path, "corrupt counts");
+    }
+
+    const uint64_t expected[SectionCount] = {vertices * sizeof(Vertex),
+                                             header->indexCount * header->indexBytes,
+                                             vertices * sizeof(uint32_t),
+                                             triangles * 3 * sizeof(int32_t),
+                                             triangles * 3,
+                                             triangles,
+                                             (vertices + 1) * sizeof(uint32_t),
+                                             triangles * 3 * sizeof(uint32_t),
+                                             triangles * sizeof(TriangleFrame),
+                                             triangles * sizeof(TriangleBasis)};
+    for (size_t i = 0; i < SectionCount; i++) {
+        uint64_t offset = header->sectionOffsets[i];
+        if (header->sectionBytes[i] != expected[i] || offset % c_Alignment != 0 || offset > m_File.size() ||
+            m_File.size() - offset < expected[i]) {
+            close();
+            return cacheError(path, "section out of bounds, file is truncated");
+        }
+    }
+
+    m_Header = header;
+    return true;
+}
+
+void MeshCache::close() {
+    m_Header = nullptr;
+    m_File.close();
+}
+
+bool MeshCache::read(const MeshCache &cache, Mesh &mesh) {
+    const Header &header = cache.getHeader();
+    size_t vertexCount = header.vertexCount;
+    size_t triangleCount = header.triangleCount;
+
+    const Vertex *vertices = sectionData<Vertex>(cache, Vertices);
+    mesh.vertices.assign(vertices, vertices + vertexCount);
+
+    if (header.indexBytes == sizeof(uint16_t)) {
+        const uint16_t *indices = sectionData<uint16_t>(cache, Indices);
+        mesh.indices.assign(indices, indices + header.indexCount);
+    } else {
+        const uint32_t *indices = sectionData<uint32_t>(cache, Indices);
+        mesh.indices.assign(indices, indices + header.indexCount);
+    }
+
+    MeshTopology &topology = mesh.topology;
+    if (!mesh.indices.empty()) {
+        topology.corners.assign(mesh.indices.begin(), mesh.indices.end());
+    } else {
+        topology.corners.resize(triangleCount * 3);
+        for (size_t i = 0; i < topology.corners.size(); i++) {
+            topology.corners[i] = static_cast<uint32_t>(i);
+        }
+    }
+
+    const uint32_t *welded = sectionData<uint32_t>(cache, WeldedVertices);
+    const int32_t *neighbors = sectionData<int32_t>(cache, Neighbors);
+    const uint8_t *neighborEdges = sectionData<uint8_t>(cache, NeighborEdges);
+    const uint8_t *boundaryMask = sectionData<uint8_t>(cache, BoundaryMask);
+    const uint32_t *starts = sectionData<uint32_t>(cache, VertexTriangleStarts);
+    const uint32_t *incident = sectionData<uint32_t>(cache, VertexTriangles);
+
+    topology.weldedVertices.assign(welded, welded + vertexCount);
+    topology.neighbors.assign(neighbors, neighbors + triangleCount * 3);
+    topology.neighborEdges.assign(neighborEdges, neighborEdges + triangleCount * 3);
+    topology.boundaryMask.assign(boundaryMask, boundaryMask + triangleCount);
+    topology.vertexTriangleStarts.assign(starts, starts + vertexCount + 1);
+    topology.vertexTriangles.assign(incident, incident + triangleCount * 3);
+    topology.weldedVertexCount = header.weldedVertexCount;
+
+    // Sizes were checked on open; ids are checked here, since the walkers index with them unchecked.
+    bool valid = allBelow(mesh.indices, vertexCount) && allBelow(topology.weldedVertices, header.weldedVertexCount) &&
+                 allBelow(topology.neighborEdges, 3) && allBelow(topology.vertexTriangles, triangleCount) &&
+                 allBelow(topology.vertexTriangleStarts, triangleCount * 3 + 1);
+    for (int32_t neighbor : topology.neighbors) {
+        valid = valid && (neighbor == MeshTopology::c_NoNeighbor ||
+                          (neighbor >= 0 && static_cast<size_t>(neighbor) < triangleCount));
+    }
+    if (!valid) {
+        mesh.vertices.clear();
+        mesh.indices.clear();
+        topology.clear();
+        return false;
+    }
+    topology.restore();
+
+    const TriangleFrame *frames = sectionData<TriangleFrame>(cache, Frames);
+    const TriangleBasis *bases = sectionData<TriangleBasis>(cache, Bases);
+    mesh.frames.frames.assign(frames, frames + triangleCount);
+    mesh.frames.bases.assign(bases, bases + triangleCount);
+    mesh.frames.restore(mesh.vertices);
+    return true;
+}
+
+} // namespace Engine
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "MappedFile.hpp"
+#include "Mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Engine {
+
+/**
+ * Binary cache of an imported mesh. A fixed header is followed by sections
+ * starting on 64 byte boundaries, in host byte order: full vertices, indices
+ * in the width the element buffer uses, then topology, triangle frames and bases, so a cached mesh is ready for
+ * particles without building anything.
+ *
+ * The header keys the cache to the size and hash of the source file, and
+ * records the record sizes, so any change to either invalidates it.
+ */
+class MeshCache {
+  public:
+    static constexpr uint32_t c_Version = 1;
+    static constexpr size_t c_Alignment = 64;
+
+    enum Section {
+        Vertices,
+        Indices,
+        WeldedVertices,
+        Neighbors,
+        NeighborEdges,
+        BoundaryMask,
+        VertexTriangleStarts,
+        VertexTriangles,
+        Frames,
+        Bases,
+        SectionCount
+    };
+
+    // Identifies the contents of a source file.
+    struct Source {
+        uint64_t bytes = 0;
+        uint64_t hash = 0;
+    };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t headerBytes;
+        uint32_t sectionCount;
+
+        // Record sizes, so a layout change reads as a stale cache
+        uint32_t vertexBytes;
+        uint32_t frameBytes;
+        uint32_t basisBytes;
+        uint32_t indexBytes;
+
+        uint64_t sourceBytes;
+        uint64_t sourceHash;
+
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        uint64_t triangleCount;
+        uint64_t weldedVertexCount;
+
+        float boundsMin[3];
+        float boundsMax[3];
+
+        uint64_t sectionOffsets[SectionCount];
+        uint64_t sectionBytes[SectionCount];
+    };
+
+  private:
+    MappedFile m_File;
+    const Header *m_Header = nullptr;
+
+  public:
+    // Hashes the whole file; false when it cannot be read.
+    static bool describe(const std::string &path, Source &source);
+
+    /**
+     * Writes the mesh, which needs its topology and frames built, through an
+     * AtomicFileWriter, so readers never map a half written cache.
+     */
+    static bool write(const std::string &path, const Source &source, const Mesh &mesh);
+
+    /**
+     * Maps the file and validates the header and section extents. Fails
+     * quietly when the file is missing or was written for another source.
+     */
+    bool open(const std::string &path, const Source &source);
+    void close();
+
+    bool isOpen() const { return m_Header != nullptr; }
+    const Header &getHeader() const { return *m_Header; }
+
+    const void *section(Section section) const { return m_File.data() + m_Header->sectionOffsets[section]; }
+
+    /**
+     * Copies the sections into mesh, which setUp() then uploads like any
+     * other; the cache can be closed afterwards. Returns false, leaving mesh
+     * empty, when an id in the cache is out of range.
+     */
+    static bool read(const MeshCache &cache, Mesh &mesh);
+};
+
+} // namespace Engine
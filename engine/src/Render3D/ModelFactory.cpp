@@ -1,12 +1,12 @@
 #include "ModelFactory.hpp"
 
-#include "Material.hpp"
 #include "Mesh.hpp"
 #include "Vertex.hpp"
 #include "TBN.hpp"
 
 #include <cmath>
 #include <numeric>
+#include <unordered_map>
 
 namespace Engine {
 
@@ -80,7 +80,6 @@ std::shared_ptr<Model> ModelFactory::createCube(float left, float right, float b
 
     Mesh mesh(vertices);
     auto model = std::shared_ptr<Model>(new Model({mesh}));
-    model->setUp();
     return model;
 }
 
@@ -135,7 +134,6 @@ std::shared_ptr<Model> ModelFactory::createPlane(float tileSize, int columns, in
 
     Mesh mesh(vertices, indices);
     auto model = std::shared_ptr<Model>(new Model({mesh}));
-    model->setUp();
     return model;
 }
 
@@ -223,7 +221,6 @@ std::shared_ptr<Model> ModelFactory::createCircle(float radius, int segments, fl
 
     Mesh mesh(vertices, indices);
     auto model = std::shared_ptr<Model>(new Model({mesh}));
-    model->setUp();
     return model;
 }
 
@@ -316,8 +313,65 @@ std::shared_ptr<Model> ModelFactory::createFrastum(float fieldOfView, float near
 
     Mesh mesh(std::move(vertices), indices);
     auto model = std::shared_ptr<Model>(new Model({std::move(mesh)}));
-    model->setUp();
     return model;
 }
 
+std::shared_ptr<Model> ModelFactory::createSphere(float radius, int subdivisions) {
+    const float t = (1.0f + std::sqrt(5.0f)) / 2.0f;
+
+    std::vector<glm::vec3> points = {
+        {-1.0f, t, 0.0f}, {1.0f, t, 0.0f}, {-1.0f, -t, 0.0f}, {1.0f, -t, 0.0f},
+        {0.0f, -1.0f, t}, {0.0f, 1.0f, t}, {0.0f, -1.0f, -t}, {0.0f, 1.0f, -t},
+        {t, 0.0f, -1.0f}, {t, 0.0f, 1.0f}, {-t, 0.0f, -1.0f}, {-t, 0.0f, 1.0f},
+    };
+
+    std::vector<unsigned int> indices = {
+        0, 11, 5, 0, 5, 1,  0, 1, 7,   0, 7,  10, 0, 10, 11, 1, 5, 9, 5, 11, 4,  11, 10, 2,  10, 7, 6, 7, 1, 8,
+        3, 9,  4, 3, 4, 2,  3, 2, 6,   3, 6,  8,  3, 8,  9,  4, 9, 5, 2, 4,  11, 6,  2,  10, 8,  6, 7, 9, 8, 1,
+    };
+
+    for (auto &point : points) {
+        point = glm::normalize(point);
+    }
+
+    // Split every triangle in four; midpoints are shared between neighbouring triangles.
+    for (int level = 0; level < subdivisions; level++) {
+        std::unordered_map<unsigned long long, unsigned int> midpoints;
+        auto midpoint = [&](unsigned int a, unsigned int b) {
+            unsigned long long key = (static_cast<unsigned long long>(std::min(a, b)) << 32) | std::max(a, b);
+            auto it = midpoints.find(key);
+            if (it != midpoints.end()) {
+                return it->second;
+            }
+
+            points.push_back(glm::normalize(points[a] + points[b]));
+            unsigned int index = static_cast<unsigned int>(points.size() - 1);
+            midpoints.emplace(key, index);
+            return index;
+        };
+
+        std::vector<unsigned int> subdivided;
+        subdivided.reserve(indices.size() * 4);
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            unsigned int a = indices[i], b = indices[i + 1], c = indices[i + 2];
+            unsigned int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+
+            for (unsigned int index : {a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca}) {
+                subdivided.push_back(index);
+            }
+        }
+        indices = std::move(subdivided);
+    }
+
+    std::vector<Vertex> vertices;
+    vertices.reserve(points.size());
+    for (const auto &point : points) {
+        glm::vec2 uv(std::atan2(point.z, point.x) / (2.0f * 3.1415926f) + 0.5f, point.y * 0.5f + 0.5f);
+        vertices.emplace_back(point * radius, point, uv, glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.8f, 0.6f, 0.1f));
+    }
+
+    Mesh mesh(vertices, indices);
+    return std::shared_ptr<Model>(new Model({mesh}));
+}
+
 } // namespace Engine
@@ -1,10 +1,15 @@
-#include <fstream>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
 #include <glm/vec3.hpp>
+#include <algorithm>
 #include <iostream>
-#include <sstream>
 #include <utility>
 
+#include "MeshCache.hpp"
 #include "ModelLoader.hpp"
+#include "ObjParser.hpp"
+#include "VertexIndexer.hpp"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -18,56 +23,186 @@
 
 namespace Engine {
 
+namespace {
 
-std::shared_ptr<Model> ModelLoader::loadObj(const std::string &path) {
-    std::ifstream in(path, std::ios::in | std::ios::binary);
-    std::stringstream dto;
-    std::string line;
+std::string &cacheDirectory() {
+    static std::string directory;
+    return directory;
+}
+
+} // namespace
+
+void ModelLoader::setCacheDirectory(const std::string &directory) { cacheDirectory() = directory; }
+
+const std::string &ModelLoader::getCacheDirectory() { return cacheDirectory(); }
+
+std::string ModelLoader::cachePath(const std::string &path) {
+    if (cacheDirectory().empty()) {
+        return path + ".mesh";
+    }
 
-    std::string attribute;
-    std::vector<glm::vec3> pVertices;
-    std::vector<glm::vec3> nVertices;
-    std::vector<glm::vec2> tVertices;
+    // The whole source path goes into the name, so equally named files from different folders do not collide.
+    std::string name = path;
+    std::replace_if(name.begin(), name.end(), [](char c) { return c == '/' || c == '\\' || c == ':'; }, '_');
+    return cacheDirectory() + "/" + name + ".mesh";
+}
+
+std::shared_ptr<Model> ModelLoader::loadObj(const std::string &path) { return importObj(path, nullptr); }
+
+std::shared_ptr<Model> ModelLoader::loadObj(const std::string &path, JobPool &jobs) { return importObj(path, &jobs); }
+
+std::shared_ptr<Model> ModelLoader::importObj(const std::string &path, JobPool *jobs) {
+    std::string cacheFile = cachePath(path);
+    MeshCache::Source source;
+    bool cacheable = MeshCache::describe(path, source);
+
+    if (cacheable) {
+        MeshCache cache;
+        if (cache.open(cacheFile, source)) {
+            auto model = std::shared_ptr<Model>(new Model());
+            model->meshes.emplace_back();
+            if (MeshCache::read(cache, model->meshes.back())) {
+                return model;
+            }
+            std::cerr << "ModelLoader: " << cacheFile << ": corrupt cache, importing again\n";
+        }
+    }
+
+    ObjParser parser;
+    if (jobs != nullptr) {
+        parser.parse(path, *jobs);
+    } else {
+        parser.parse(path);
+    }
+
+    const ObjParser::Stats &stats = parser.getStats();
+    if (stats.skippedFaces > 0 || stats.skippedTriangles > 0) {
+        std::cerr << "ModelLoader: " << path << ": skipped " << stats.skippedFaces << " malformed faces and "
+                  << stats.skippedTriangles << " triangles with missing elements\n";
+    }
+
+    // OBJ corners share their elements, so the soup collapses to far fewer unique vertices.
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
+    VertexIndexer::Stats indexed = VertexIndexer::index(parser.getVertices(), vertices, indices);
+    std::cout << "ModelLoader: " << path << ": " << indexed.soupVertices << " corners to " << indexed.vertices
+              << " vertices with " << indexed.indexBytes * 8 << "-bit indices, "
+              << indexed.savedBytes() / 1024 << " KiB saved\n";
 
-    while (!in.eof() && in >> attribute) {
-        if (attribute == "o") {
-        } else if (attribute == "v") {
-            float x, y, z;
-            in >> x >> y >> z;
-            pVertices.emplace_back(x, y, z);
-        } else if (attribute == "vt") {
-            float x, y;
-            in >> x >> y;
-            tVertices.emplace_back(x, y);
-        } else if (attribute == "vn") {
-            float x, y, z;
-            in >> x >> y >> z;
-            nVertices.emplace_back(x, y, z);
-        } else if (attribute == "f") {
-            char divider;
-            size_t p, t, n;
-            in >> p >> divider >> t >> divider >> n;
-            vertices.emplace_back(pVertices[p - 1], nVertices[n - 1], tVertices[t - 1], glm::vec3(1.0f, 0.0f, 0.0f),
-                                  glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f));
-            in >> p >> divider >> t >> divider >> n;
-            vertices.emplace_back(pVertices[p - 1], nVertices[n - 1], tVertices[t - 1], glm::vec3(1.0f, 0.0f, 0.0f),
-                                  glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f));
-            in >> p >> divider >> t >> divider >> n;
-            vertices.emplace_back(pVertices[p - 1], nVertices[n - 1], tVertices[t - 1], glm::vec3(1.0f, 0.0f, 0.0f),
-                                  glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f));
-        } else {
-            std::getline(in, line);
+    auto model = std::shared_ptr<Model>(new Model());
+    model->meshes.emplace_back(vertices, indices);
+
+    // Built once here so that the cache has them for the next start.
+    Mesh &mesh = model->meshes.back();
+    mesh.buildTopology();
+    mesh.buildFrames();
+
+    if (cacheable && !mesh.topology.empty()) {
+        MeshCache::write(cacheFile, source, mesh);
+    }
+    return model;
+}
+
+std::shared_ptr<Model> ModelLoader::load(const std::string &path) {
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
+                                                       aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace |
+                                                       aiProcess_PreTransformVertices | aiProcess_SortByPType);
+    if (scene == nullptr || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) != 0) {
+        std::cerr << "ModelLoader: " << path << ": " << importer.GetErrorString() << "\n";
+        return nullptr;
+    }
+
+    auto model = std::shared_ptr<Model>(new Model());
+    std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+
+    for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
+        aiMaterial *source = scene->mMaterials[i];
+        ModelMaterial material;
+
+        aiString name;
+        if (source->Get(AI_MATKEY_NAME, name) == AI_SUCCESS) {
+            material.name = name.C_Str();
         }
+
+        aiColor3D diffuse(1.0f, 1.0f, 1.0f);
+        source->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse);
+        material.diffuse = glm::vec3(diffuse.r, diffuse.g, diffuse.b);
+
+        aiString texture;
+        if (source->GetTexture(aiTextureType_DIFFUSE, 0, &texture) == AI_SUCCESS) {
+            material.diffuseTexture = directory + texture.C_Str();
+        }
+        model->materials.push_back(material);
     }
 
-    in.close();
+    // Sized once, so no mesh is relocated as the array grows; skipped point and line meshes leave slots unused.
+    model->meshes.reserve(scene->mNumMeshes);
+    model->meshMaterials.reserve(scene->mNumMeshes);
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
+        const aiMesh *source = scene->mMeshes[i];
+        // Points and lines come in meshes of their own after aiProcess_SortByPType.
+        if ((source->mPrimitiveTypes & aiPrimitiveType_TRIANGLE) == 0) {
+            continue;
+        }
+
+        glm::vec3 color = source->mMaterialIndex < model->materials.size()
+                              ? model->materials[source->mMaterialIndex].diffuse
+                              : glm::vec3(1.0f);
+
+        std::vector<Vertex> vertices(source->mNumVertices);
+        for (unsigned int v = 0; v < source->mNumVertices; v++) {
+            Vertex &vertex = vertices[v];
+            vertex.position = glm::vec3(source->mVertices[v].x, source->mVertices[v].y, source->mVertices[v].z);
+            if (source->HasNormals()) {
+                vertex.normal = glm::vec3(source->mNormals[v].x, source->mNormals[v].y, source->mNormals[v].z);
+            }
+            if (source->HasTextureCoords(0)) {
+                vertex.textCoord = glm::vec2(source->mTextureCoords[0][v].x, source->mTextureCoords[0][v].y);
+            }
+            if (source->HasTangentsAndBitangents()) {
+                vertex.tangent = glm::vec3(source->mTangents[v].x, source->mTangents[v].y, source->mTangents[v].z);
+                vertex.bitangent =
+                    glm::vec3(source->mBitangents[v].x, source->mBitangents[v].y, source->mBitangents[v].z);
+            } else {
+                vertex.tangent = glm::vec3(1.0f, 0.0f, 0.0f);
+                vertex.bitangent = glm::vec3(0.0f, 0.0f, 1.0f);
+            }
+            vertex.color = color;
+        }
+
+        std::vector<unsigned int> indices;
+        indices.reserve(source->mNumFaces * 3);
+        for (unsigned int f = 0; f < source->mNumFaces; f++) {
+            const aiFace &face = source->mFaces[f];
+            if (face.mNumIndices == 3) {
+                indices.insert(indices.end(), face.mIndices, face.mIndices + 3);
+            }
+        }
+
+        model->meshes.emplace_back(vertices, indices);
+        model->meshes.back().buildTopology();
+        model->meshMaterials.push_back(source->mMaterialIndex);
+    }
 
-    Mesh mesh(vertices, indices);
-    auto model = std::shared_ptr<Model>(new Model({mesh}));
-    model->setUp();
     return model;
 }
 
+std::shared_ptr<ModelImport> ModelLoader::loadAsync(const std::string &path, ModelStreamer &streamer) {
+    auto import = std::make_shared<ModelImport>(path);
+
+    streamer.submit([import, &streamer]() {
+        import->m_Model = load(import->m_Path);
+        if (import->m_Model == nullptr) {
+            import->m_State = ModelImport::State::Failed;
+            return;
+        }
+
+        import->m_State = ModelImport::State::Uploading;
+        streamer.queueUpload(import);
+    });
+
+    return import;
+}
+
 } // namespace Engine
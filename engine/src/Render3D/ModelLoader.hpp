@@ -2,13 +2,44 @@
 
 #include <string>
 
+#include "JobPool.hpp"
 #include "Model.hpp"
+#include "ModelStreamer.hpp"
 
 namespace Engine {
 
+/**
+ * Loads models into CPU memory. Call Model::setUp() before drawing to upload
+ * them to the GPU.
+ *
+ * OBJ imports are cached in a binary .mesh file, next to the source or in
+ * the cache directory when one is set, which later loads map instead of
+ * parsing while the source stays the same.
+ *
+ * load() takes any format assimp reads, with every mesh and material of the
+ * file; node transforms are baked into the vertices.
+ */
 class ModelLoader {
   public:
     static std::shared_ptr<Model> loadObj(const std::string &path);
+    static std::shared_ptr<Model> loadObj(const std::string &path, JobPool &jobs);
+
+    // An existing directory for .mesh caches; empty, the default, keeps them next to their sources.
+    static void setCacheDirectory(const std::string &directory);
+    static const std::string &getCacheDirectory();
+
+    // Returns null when the file cannot be imported. Does not touch the GPU.
+    static std::shared_ptr<Model> load(const std::string &path);
+
+    /**
+     * Imports with load() on a streamer thread, then lets the streamer set
+     * the meshes up on the GL thread. Poll the returned import for the model.
+     */
+    static std::shared_ptr<ModelImport> loadAsync(const std::string &path, ModelStreamer &streamer);
+
+  private:
+    static std::shared_ptr<Model> importObj(const std::string &path, JobPool *jobs);
+    static std::string cachePath(const std::string &path);
 };
 
 } // namespace Engine
@@ -0,0 +1,59 @@
+#include "ModelStreamer.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Engine {
+
+ModelStreamer::ModelStreamer(unsigned threads) : m_Jobs(std::max(threads, 1u)) {}
+
+void ModelStreamer::submit(const std::function<void()> &import) {
+    m_Jobs.submit([import](unsigned) { import(); });
+}
+
+void ModelStreamer::queueUpload(const std::shared_ptr<ModelImport> &import) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Uploads.push_back(import);
+}
+
+size_t ModelStreamer::upload() {
+    auto start = std::chrono::steady_clock::now();
+    size_t uploaded = 0;
+    double elapsed = 0.0;
+
+    while (uploaded == 0 || elapsed < m_BudgetSeconds) {
+        std::shared_ptr<ModelImport> import;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Uploads.empty()) {
+                break;
+            }
+            import = m_Uploads.front();
+        }
+
+        // Only this thread takes from the front, so the import stays there while its meshes go up.
+        auto &meshes = import->m_Model->meshes;
+        if (import->m_UploadedMeshes < meshes.size()) {
+            meshes[import->m_UploadedMeshes++].setUp();
+            uploaded++;
+        }
+
+        if (import->m_UploadedMeshes == meshes.size()) {
+            import->m_State = ModelImport::State::Ready;
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Uploads.pop_front();
+        }
+
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    m_LastUploadSeconds = elapsed;
+    return uploaded;
+}
+
+size_t ModelStreamer::pendingUploads() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Uploads.size();
+}
+
+} // namespace Engine
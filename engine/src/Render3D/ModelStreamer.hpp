@@ -0,0 +1,88 @@
+#pragma once
+
+#include "JobPool.hpp"
+#include "Model.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Engine {
+
+/**
+ * A model loading in the background, as returned by ModelLoader::loadAsync().
+ * It moves from Importing to Uploading once its CPU data is complete, and to
+ * Ready once every mesh is on the GPU; Failed if the import failed.
+ */
+class ModelImport {
+  public:
+    enum class State { Importing, Uploading, Ready, Failed };
+
+  private:
+    friend class ModelLoader;
+    friend class ModelStreamer;
+
+    std::string m_Path;
+    std::atomic<State> m_State{State::Importing};
+    std::shared_ptr<Model> m_Model;
+    size_t m_UploadedMeshes = 0;
+
+  public:
+    explicit ModelImport(const std::string &path) : m_Path(path) {}
+
+    State getState() const { return m_State.load(); }
+    bool isReady() const { return getState() == State::Ready; }
+    bool isDone() const { return getState() == State::Ready || getState() == State::Failed; }
+
+    // Null until the model is Ready.
+    std::shared_ptr<Model> getModel() const { return isReady() ? m_Model : nullptr; }
+    const std::string &getPath() const { return m_Path; }
+};
+
+/**
+ * Runs model imports on its own worker thread and feeds the finished meshes
+ * to the GPU a few at a time. The engine's JobPool is not used: the frame
+ * waits for all of its jobs, and an import may take seconds.
+ *
+ * upload() must be called on the GL thread, once per frame. It sets up
+ * whole meshes until the frame budget is spent, and at least one, so every
+ * import finishes even with a tiny budget.
+ */
+class ModelStreamer {
+  private:
+    std::mutex m_Mutex;
+    std::deque<std::shared_ptr<ModelImport>> m_Uploads;
+
+    double m_BudgetSeconds = 0.002;
+    double m_LastUploadSeconds = 0.0;
+
+    // Declared last so that it joins the import threads before the queue goes away.
+    JobPool m_Jobs;
+
+  public:
+    explicit ModelStreamer(unsigned threads = 1);
+
+    ModelStreamer(const ModelStreamer &) = delete;
+    ModelStreamer &operator=(const ModelStreamer &) = delete;
+
+    // Runs import on a worker thread.
+    void submit(const std::function<void()> &import);
+
+    // Thread safe; called by imports once their model is complete on the CPU.
+    void queueUpload(const std::shared_ptr<ModelImport> &import);
+
+    // Returns the number of meshes set up.
+    size_t upload();
+
+    size_t pendingUploads();
+
+    void setBudget(double seconds) { m_BudgetSeconds = seconds; }
+    double getBudget() const { return m_BudgetSeconds; }
+    double getLastUploadSeconds() const { return m_LastUploadSeconds; }
+};
+
+} // namespace Engine
@@ -1,10 +1,27 @@
 #include "glad/glad.h"
+#include <algorithm>
 #include <iostream>
+#include <utility>
 
 #include "Mesh.hpp"
 
 namespace Engine {
 
+namespace {
+
+GLenum bufferUsage(Mesh::Usage usage) {
+    switch (usage) {
+    case Mesh::Usage::Dynamic:
+        return GL_DYNAMIC_DRAW;
+    case Mesh::Usage::Stream:
+        return GL_STREAM_DRAW;
+    default:
+        return GL_STATIC_DRAW;
+    }
+}
+
+} // namespace
+
 Mesh::Mesh() {}
 Mesh::~Mesh() {}
 
@@ -12,64 +29,100 @@ Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indic
 
 Mesh::Mesh(const std::vector<Vertex> &vertices) : vertices(vertices) {}
 
-Mesh::Mesh(const Mesh &mesh) {
-    VAO = mesh.VAO;
-    EBO = mesh.EBO;
-    VBO = mesh.VBO;
+Mesh::Mesh(const Mesh &mesh) { copyFrom(mesh); }
+
+Mesh::Mesh(Mesh &&mesh) noexcept { moveFrom(mesh); }
+
+Mesh &Mesh::operator=(const Mesh &mesh) {
+    if (this != &mesh) {
+        copyFrom(mesh);
+    }
+    return *this;
+}
+
+Mesh &Mesh::operator=(Mesh &&mesh) noexcept {
+    if (this != &mesh) {
+        moveFrom(mesh);
+    }
+    return *this;
+}
+
+void Mesh::copyFrom(const Mesh &mesh) {
+    m_VertexArray = mesh.m_VertexArray;
+    m_VertexBuffer = mesh.m_VertexBuffer;
+    m_IndexBuffer = mesh.m_IndexBuffer;
+    m_InstanceBuffer = mesh.m_InstanceBuffer;
+    m_InstanceCapacity = mesh.m_InstanceCapacity;
+    m_IndexBytes = mesh.m_IndexBytes;
+    m_Layout = mesh.m_Layout;
+    m_Usage = mesh.m_Usage;
+    m_UploadStats = mesh.m_UploadStats;
 
     vertices = mesh.vertices;
     indices = mesh.indices;
+    topology = mesh.topology;
+    frames = mesh.frames;
+    sampler = mesh.sampler;
+    positions = mesh.positions;
+
+    m_DirtyVertices = mesh.m_DirtyVertices;
+    m_DirtyIndices = mesh.m_DirtyIndices;
+    m_SamplerStale = mesh.m_SamplerStale;
+}
+
+void Mesh::moveFrom(Mesh &mesh) noexcept {
+    m_VertexArray = std::move(mesh.m_VertexArray);
+    m_VertexBuffer = std::move(mesh.m_VertexBuffer);
+    m_IndexBuffer = std::move(mesh.m_IndexBuffer);
+    m_InstanceBuffer = std::move(mesh.m_InstanceBuffer);
+    m_InstanceCapacity = std::exchange(mesh.m_InstanceCapacity, 0);
+    m_IndexBytes = mesh.m_IndexBytes;
+    m_Layout = mesh.m_Layout;
+    m_Usage = mesh.m_Usage;
+    m_UploadStats = mesh.m_UploadStats;
+
+    vertices = std::move(mesh.vertices);
+    indices = std::move(mesh.indices);
+    topology = std::move(mesh.topology);
+    frames = std::move(mesh.frames);
+    sampler = std::move(mesh.sampler);
+    positions = std::move(mesh.positions);
+
+    m_DirtyVertices = mesh.m_DirtyVertices;
+    m_DirtyIndices = mesh.m_DirtyIndices;
+    m_SamplerStale = mesh.m_SamplerStale;
+}
+
+bool Mesh::detachShared() {
+    if (!m_VertexArray.shared() && !m_VertexBuffer.shared() && !m_IndexBuffer.shared() && !m_InstanceBuffer.shared()) {
+        return false;
+    }
+
+    m_VertexArray.reset();
+    m_VertexBuffer.reset();
+    m_IndexBuffer.reset();
+    m_InstanceBuffer.reset();
+    m_InstanceCapacity = 0;
+    return true;
 }
 
 void Mesh::setUp() {
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-
-    glGenBuffers(1, &EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * static_cast<GLuint>(indices.size()), indices.data(),
-                 GL_STATIC_DRAW);
-
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(Vertex) * vertices.size()), vertices.data(),
-                 GL_STATIC_DRAW);
-
-    /////////////////////////////////////////////////////////////
-    ///////////////////////// POSITION //////////////////////////
-    /////////////////////////////////////////////////////////////
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void *>(0));
-    glEnableVertexAttribArray(0);
-
-    /////////////////////////////////////////////////////////////
-    ////////////////////////// NORMAL ///////////////////////////
-    /////////////////////////////////////////////////////////////
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void *>(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    /////////////////////////////////////////////////////////////
-    ////////////////////// TEXTURE COORD ////////////////////////
-    /////////////////////////////////////////////////////////////
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void *>(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    /////////////////////////////////////////////////////////////
-    ///////////////////////// TANGENT ///////////////////////////
-    /////////////////////////////////////////////////////////////
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void *>(8 * sizeof(float)));
-    glEnableVertexAttribArray(3);
-
-    /////////////////////////////////////////////////////////////
-    //////////////////////// BITANGENT //////////////////////////
-    /////////////////////////////////////////////////////////////
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void *>(11 * sizeof(float)));
-    glEnableVertexAttribArray(4);
-
-    /////////////////////////////////////////////////////////////
-    ////////////////////////// COLOR ////////////////////////////
-    /////////////////////////////////////////////////////////////
-    glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void *>(14 * sizeof(float)));
-    glEnableVertexAttribArray(5);
+    // Calling again re-sends everything into the same objects, unless a copy shares them.
+    detachShared();
+    if (!m_VertexArray) {
+        m_VertexArray = GpuHandle::create(GpuResources::VertexArray);
+        m_VertexBuffer = GpuHandle::create(GpuResources::Buffer);
+        m_IndexBuffer = GpuHandle::create(GpuResources::Buffer);
+    }
+    glBindVertexArray(m_VertexArray.get());
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBuffer.get());
+    uploadIndices(0, indices.size());
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_VertexBuffer.get());
+    uploadVertices(0, vertices.size());
+
+    m_Layout.apply();
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
@@ -77,22 +130,256 @@ void Mesh::setUp() {
 }
 
 void Mesh::update() {
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(Vertex) * vertices.size()), vertices.data(),
-                 GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (m_DirtyVertices.empty() && m_DirtyIndices.empty()) {
+        markVerticesDirty(0, vertices.size());
+        markIndicesDirty(0, indices.size());
+    }
+
+    // commitChanges() consumes the ranges.
+    DirtyRange dirtyVertices = m_DirtyVertices;
+    DirtyRange dirtyIndices = m_DirtyIndices;
+
+    // Particles walk the CPU-side caches, so keep them in step with the edit.
+    commitChanges();
+
+    if (detachShared()) {
+        setUp();
+        return;
+    }
+
+    if (!dirtyVertices.empty() || m_Layout.getStride() * vertices.size() != m_VertexBuffer.getBytes()) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_VertexBuffer.get());
+        uploadVertices(dirtyVertices.begin, dirtyVertices.size());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // A vertex count crossing 2^16 changes the index width, so the indices go too.
+    if (!dirtyIndices.empty() || VertexIndexer::indexBytes(vertices.size()) != m_IndexBytes) {
+        // The element buffer binding belongs to the vertex array.
+        glBindVertexArray(m_VertexArray.get());
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBuffer.get());
+        uploadIndices(dirtyIndices.begin, dirtyIndices.size());
+        glBindVertexArray(0);
+    }
+}
+
+void Mesh::uploadVertices(size_t first, size_t count) {
+    size_t stride = m_Layout.getStride();
+    size_t totalBytes = stride * vertices.size();
+    if (totalBytes != m_VertexBuffer.getBytes() || m_Usage == Usage::Stream) {
+        first = 0;
+        count = vertices.size();
+    }
+    first = std::min(first, vertices.size());
+    count = std::min(count, vertices.size() - first);
+
+    const void *data = vertices.data() + first;
+    if (!m_Layout.isFull()) {
+        m_Staging.resize(stride * count);
+        m_Layout.pack(vertices, first, count, m_Staging.data());
+        data = m_Staging.data();
+    }
+
+    writeBuffer(GL_ARRAY_BUFFER, m_VertexBuffer, totalBytes, stride * first, stride * count, data);
+}
+
+void Mesh::uploadIndices(size_t first, size_t count) {
+    size_t indexBytes = VertexIndexer::indexBytes(vertices.size());
+    size_t totalBytes = indexBytes * indices.size();
+    if (indexBytes != m_IndexBytes || totalBytes != m_IndexBuffer.getBytes() || m_Usage == Usage::Stream) {
+        first = 0;
+        count = indices.size();
+    }
+    first = std::min(first, indices.size());
+    count = std::min(count, indices.size() - first);
+    m_IndexBytes = indexBytes;
+
+    const void *data = indices.data() + first;
+    if (m_IndexBytes == sizeof(GLushort)) {
+        m_Staging.resize(sizeof(GLushort) * count);
+        GLushort *shortIndices = reinterpret_cast<GLushort *>(m_Staging.data());
+        std::copy(indices.begin() + first, indices.begin() + first + count, shortIndices);
+        data = shortIndices;
+    }
+
+    writeBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBuffer, totalBytes, m_IndexBytes * first, m_IndexBytes * count, data);
+}
+
+void Mesh::writeBuffer(unsigned int target, const GpuHandle &buffer, size_t totalBytes, size_t offset, size_t bytes,
+                       const void *data) {
+    GLenum usage = bufferUsage(m_Usage);
+
+    // New storage only when the size changes; callers then pass the whole buffer.
+    if (totalBytes != buffer.getBytes()) {
+        glBufferData(target, static_cast<GLsizeiptr>(totalBytes), data, usage);
+        buffer.setBytes(totalBytes);
+        m_UploadStats.reallocations++;
+        m_UploadStats.uploads++;
+        m_UploadStats.bytes += totalBytes;
+        return;
+    }
+    if (bytes == 0) {
+        return;
+    }
+
+    // Orphaning hands the driver fresh storage, so the write does not wait for draws still reading the old one.
+    if (m_Usage == Usage::Stream) {
+        glBufferData(target, static_cast<GLsizeiptr>(totalBytes), nullptr, usage);
+        m_UploadStats.orphans++;
+    }
+    glBufferSubData(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes), data);
+    m_UploadStats.uploads++;
+    m_UploadStats.bytes += bytes;
+}
+
+void Mesh::setInstances(const float *rows, size_t count) {
+    GLsizeiptr size = static_cast<GLsizeiptr>(sizeof(float) * c_InstanceFloats * count);
+
+    if (detachShared()) {
+        setUp();
+    }
+
+    if (!m_InstanceBuffer) {
+        m_InstanceBuffer = GpuHandle::create(GpuResources::Buffer);
+
+        glBindVertexArray(m_VertexArray.get());
+        glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBuffer.get());
+
+        /////////////////////////////////////////////////////////////
+        //////////////////// INSTANCE TRANSFORM /////////////////////
+        /////////////////////////////////////////////////////////////
+        for (GLuint row = 0; row < 3; row++) {
+            glVertexAttribPointer(6 + row, 4, GL_FLOAT, GL_FALSE, c_InstanceFloats * sizeof(float),
+                                  reinterpret_cast<void *>(row * 4 * sizeof(float)));
+            glEnableVertexAttribArray(6 + row);
+            glVertexAttribDivisor(6 + row, 1);
+        }
+
+        glBindVertexArray(0);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBuffer.get());
+    }
+
+    // Grow geometrically so a slowly growing particle count does not reallocate every frame.
+    if (count > m_InstanceCapacity) {
+        m_InstanceCapacity = std::max(count, m_InstanceCapacity * 2);
+        size_t capacityBytes = sizeof(float) * c_InstanceFloats * m_InstanceCapacity;
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacityBytes), nullptr, GL_STREAM_DRAW);
+        m_InstanceBuffer.setBytes(capacityBytes);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, rows);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * static_cast<GLuint>(indices.size()), indices.data(),
-                 GL_STATIC_DRAW);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+void Mesh::buildTopology() { topology.build(vertices, indices); }
+
+void Mesh::buildFrames() { frames.build(vertices, topology); }
+
+void Mesh::buildSampler() {
+    sampler.build(frames);
+    m_SamplerStale = false;
+}
+
+void Mesh::buildPositions() { positions.build(vertices, topology); }
+
+void Mesh::markVerticesDirty(size_t first, size_t count) { m_DirtyVertices.add(first, count); }
+
+void Mesh::markIndicesDirty(size_t first, size_t count) { m_DirtyIndices.add(first, count); }
+
+void Mesh::commitChanges() {
+    if (m_DirtyVertices.empty() && m_DirtyIndices.empty()) {
+        return;
+    }
+
+    DirtyRange dirtyVertices = m_DirtyVertices;
+    DirtyRange dirtyIndices = m_DirtyIndices;
+    m_DirtyVertices.clear();
+    m_DirtyIndices.clear();
+
+    // Nothing derived from the geometry yet.
+    if (topology.empty()) {
+        return;
+    }
+
+    size_t triangleCount = (indices.empty() ? vertices.size() : indices.size()) / 3;
+    bool rebuild = vertices.size() != topology.weldedVertices.size() || triangleCount != topology.triangleCount();
+    if (rebuild) {
+        buildTopology();
+        if (!frames.empty()) {
+            buildFrames();
+        }
+        if (!positions.empty()) {
+            buildPositions();
+        }
+    }
+
+    m_Change.reset(topology.triangleCount());
+    m_Change.vertices = dirtyVertices;
+    m_Change.indices = dirtyIndices;
+    m_Change.rebuilt = rebuild;
+
+    if (!rebuild) {
+        size_t first = 0;
+        size_t last = 0;
+        if (!m_Change.indices.empty() && !indices.empty()) {
+            first = m_Change.indices.begin / 3;
+            last = std::min((m_Change.indices.end + 2) / 3, triangleCount);
+
+            // Corners as the frames last saw them, before the topology moves on.
+            for (size_t triangle = first; triangle < last; triangle++) {
+                glm::vec3 corners[3];
+                for (int k = 0; k < 3; k++) {
+                    uint32_t vertex = topology.corner(triangle, k);
+                    corners[k] = frames.empty() ? vertices[vertex].position : frames.lastPosition(vertex);
+                }
+                m_Change.add(static_cast<uint32_t>(triangle), corners[0], corners[1], corners[2]);
+            }
+
+            topology.update(indices, first, last - first);
+        }
+
+        if (!frames.empty()) {
+            frames.update(vertices, topology, m_Change.vertices.begin, m_Change.vertices.size(), m_Change);
+        }
+        if (!positions.empty()) {
+            positions.update(vertices, topology, m_Change.vertices.begin, m_Change.vertices.size(), first,
+                             last - first);
+        }
+    }
+
+    if (!m_Change.empty() && !sampler.empty()) {
+        m_SamplerStale = true;
+    }
+
+    for (auto &listener : m_ChangeListeners) {
+        listener.second(m_Change);
+    }
+}
+
+size_t Mesh::addChangeListener(const ChangeListener &listener) {
+    m_ChangeListeners.emplace_back(m_NextListenerId, listener);
+    return m_NextListenerId++;
+}
+
+void Mesh::removeChangeListener(size_t id) {
+    m_ChangeListeners.erase(std::remove_if(m_ChangeListeners.begin(), m_ChangeListeners.end(),
+                                           [id](const auto &listener) { return listener.first == id; }),
+                            m_ChangeListeners.end());
+}
+
+void Mesh::updateSampler() {
+    if (m_SamplerStale) {
+        buildSampler();
+    }
+}
+
 void Mesh::draw() const {
-    glBindVertexArray(VAO);
+    glBindVertexArray(m_VertexArray.get());
 
     if (indices.size() > 0) {
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
+        GLenum type = m_IndexBytes == sizeof(GLushort) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), type, 0);
     } else {
         glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
     }
@@ -100,4 +387,22 @@ void Mesh::draw() const {
     glBindVertexArray(0);
 }
 
+void Mesh::drawInstanced(size_t count) const {
+    if (count == 0) {
+        return;
+    }
+
+    glBindVertexArray(m_VertexArray.get());
+
+    if (indices.size() > 0) {
+        GLenum type = m_IndexBytes == sizeof(GLushort) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), type, 0,
+                                static_cast<GLsizei>(count));
+    } else {
+        glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()), static_cast<GLsizei>(count));
+    }
+
+    glBindVertexArray(0);
+}
+
 } // namespace Engine
@@ -1,32 +1,174 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "GpuResources.hpp"
+#include "MeshChange.hpp"
+#include "MeshPositions.hpp"
+#include "MeshTopology.hpp"
+#include "SurfaceSampler.hpp"
+#include "TriangleFrames.hpp"
 #include "Vertex.hpp"
+#include "VertexIndexer.hpp"
+#include "VertexLayout.hpp"
 
 namespace Engine {
 
 class Mesh {
   public:
+    using ChangeListener = std::function<void(const MeshChange &change)>;
+
+    // How often the GPU buffers change; picks the usage hint and how update() writes them.
+    enum class Usage {
+        // Written once by setUp()
+        Static,
+        // Edited now and then: update() sends the dirty ranges only
+        Dynamic,
+        // Rewritten every frame: update() orphans the buffers and sends them whole
+        Stream
+    };
+
+    // Buffer writes since the last reset; a reallocation is new storage at a new size.
+    struct UploadStats {
+        size_t uploads = 0;
+        size_t bytes = 0;
+        size_t reallocations = 0;
+        size_t orphans = 0;
+    };
+
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
+    MeshTopology topology;
+    TriangleFrames frames;
+    SurfaceSampler sampler;
+    // Optional packed positions for CPU queries; kept in step by commitChanges() once built.
+    MeshPositions positions;
 
     Mesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices);
     Mesh(const std::vector<Vertex> &vertices);
 
+    /**
+     * Copies share the GPU objects until one of them writes to them with
+     * setUp(), update() or setInstances(); that one first gets objects of its
+     * own, filled from its CPU data, so no write shows through another copy.
+     * Change listeners belong to the object and are never copied or moved.
+     */
     Mesh(const Mesh &mesh);
+    Mesh(Mesh &&mesh) noexcept;
+    Mesh &operator=(const Mesh &mesh);
+    Mesh &operator=(Mesh &&mesh) noexcept;
 
     Mesh();
     ~Mesh();
 
     void draw() const;
+    void drawInstanced(size_t count) const;
+
+    /**
+     * Uploads per-instance transforms as packed 3x4 row-major matrices
+     * (12 floats per instance) and binds them to attribute locations 6..8.
+     */
+    void setInstances(const float *rows, size_t count);
 
     void setUp();
+
+    // Format of the vertex buffer; set before setUp(). The CPU side always keeps full Vertex values.
+    void setLayout(const VertexLayout &layout) { m_Layout = layout; }
+    const VertexLayout &getLayout() const { return m_Layout; }
+
+    // Set before setUp().
+    void setUsage(Usage usage) { m_Usage = usage; }
+    Usage getUsage() const { return m_Usage; }
+
+    /**
+     * Commits the marked ranges and sends just those to the GPU with
+     * glBufferSubData, or everything in Stream usage or when the vertex or
+     * index count changed. Without any marked range, everything is dirty.
+     */
     void update();
+    void buildTopology();
+    void buildFrames();
+    void buildSampler();
+    void buildPositions();
 
-  public:
-    unsigned int VAO, VBO, EBO;
+    // Position of corner k of a triangle, from the packed copy when there is one.
+    glm::vec3 cornerPosition(size_t triangle, int k) const {
+        return positions.empty() ? vertices[topology.corner(triangle, k)].position : positions.corner(triangle, k);
+    }
+
+    /**
+     * Record edits to vertices or indices since the last commit. Ranges are
+     * merged into one per array, so mark edits close to each other.
+     */
+    void markVerticesDirty(size_t first, size_t count);
+    void markIndicesDirty(size_t first, size_t count);
+
+    /**
+     * Patches topology, triangle frames and packed positions for the marked
+     * ranges only and passes what changed to the listeners. Changing the
+     * vertex or triangle count rebuilds everything. Does not touch the GPU.
+     */
+    void commitChanges();
+
+    // Listeners stay with this object and must be removed before they go away.
+    size_t addChangeListener(const ChangeListener &listener);
+    void removeChangeListener(size_t id);
+
+    /**
+     * The sampler is only needed to spawn, so after edits that change triangle
+     * areas it is rebuilt on the next call to this instead of on every commit.
+     */
+    void updateSampler();
+
+    // Bytes per index in the element buffer: 2 when vertices fit 16-bit indices, else 4.
+    size_t getIndexBytes() const { return m_IndexBytes; }
+
+    const UploadStats &getUploadStats() const { return m_UploadStats; }
+    void resetUploadStats() { m_UploadStats = UploadStats(); }
+
+    static constexpr size_t c_InstanceFloats = 12;
+
+  private:
+    // Shared by copies of the mesh until one writes, and deleted with the last one
+    GpuHandle m_VertexArray;
+    GpuHandle m_VertexBuffer;
+    GpuHandle m_IndexBuffer;
+    GpuHandle m_InstanceBuffer;
+    size_t m_InstanceCapacity = 0;
+
+    VertexLayout m_Layout;
+    Usage m_Usage = Usage::Static;
+    size_t m_IndexBytes = 4;
+
+    UploadStats m_UploadStats;
+    // Reused for packed vertices and narrowed indices
+    std::vector<uint8_t> m_Staging;
+
+    DirtyRange m_DirtyVertices;
+    DirtyRange m_DirtyIndices;
+    bool m_SamplerStale = false;
+
+    MeshChange m_Change;
+    std::vector<std::pair<size_t, ChangeListener>> m_ChangeListeners;
+    size_t m_NextListenerId = 1;
+
+    void copyFrom(const Mesh &mesh);
+    void moveFrom(Mesh &mesh) noexcept;
+    // Drops GPU objects another copy still refers to; true when there were any, and setUp() is due.
+    bool detachShared();
+
+    // Write a range of the bound vertex and element buffers, packing vertices to the layout and
+    // narrowing indices when the vertex count allows.
+    void uploadVertices(size_t first, size_t count);
+    void uploadIndices(size_t first, size_t count);
+    // Reallocates when totalBytes differs from the buffer's registered size.
+    void writeBuffer(unsigned int target, const GpuHandle &buffer, size_t totalBytes, size_t offset, size_t bytes,
+                     const void *data);
 };
 
 } // namespace Engine
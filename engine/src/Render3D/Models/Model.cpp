@@ -8,6 +8,18 @@ Model::Model() {}
 
 Model::Model(const std::vector<Mesh> &meshes) : meshes(meshes) {}
 
+void Model::setLayout(const VertexLayout &layout) {
+    for (auto &mesh : meshes) {
+        mesh.setLayout(layout);
+    }
+}
+
+void Model::setUsage(Mesh::Usage usage) {
+    for (auto &mesh : meshes) {
+        mesh.setUsage(usage);
+    }
+}
+
 void Model::setUp() {
     for (auto &mesh : meshes) {
         mesh.setUp();
@@ -26,4 +38,16 @@ void Model::draw() {
     }
 }
 
+void Model::drawInstanced(size_t count) {
+    for (const auto &mesh : meshes) {
+        mesh.drawInstanced(count);
+    }
+}
+
+void Model::setInstances(const float *rows, size_t count) {
+    for (auto &mesh : meshes) {
+        mesh.setInstances(rows, count);
+    }
+}
+
 } // namespace Engine
@@ -2,21 +2,44 @@
 
 #include "Mesh.hpp"
 
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 namespace Engine {
 
+// Surface description read from an imported file. Textures are only named;
+// loading them needs the GL thread.
+struct ModelMaterial {
+    std::string name;
+    glm::vec3 diffuse = glm::vec3(1.0f);
+    std::string diffuseTexture;
+};
+
 class Model {
   public:
     std::vector<Mesh> meshes;
 
+    // Filled by ModelLoader::load(); meshMaterials[i] indexes materials for meshes[i].
+    std::vector<ModelMaterial> materials;
+    std::vector<uint32_t> meshMaterials;
+
     Model();
     Model(const std::vector<Mesh> &meshes);
 
+    // Applies to every mesh; call before setUp().
+    void setLayout(const VertexLayout &layout);
+    void setUsage(Mesh::Usage usage);
+
     void setUp();
     void update();
     void draw();
+    void drawInstanced(size_t count);
+
+    void setInstances(const float *rows, size_t count);
 
 };
 
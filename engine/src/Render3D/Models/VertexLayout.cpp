@@ -0,0 +1,208 @@
+#include "VertexLayout.hpp"
+
+#include "glad/glad.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/packing.hpp>
+
+#include <cstring>
+
+namespace Engine {
+
+namespace {
+
+const VertexLayout::Format c_FullFormats[VertexLayout::AttributeCount] = {
+    VertexLayout::Format::Float3, VertexLayout::Format::Float3, VertexLayout::Format::Float2,
+    VertexLayout::Format::Float3, VertexLayout::Format::Float3, VertexLayout::Format::Float3};
+
+bool fitsAttribute(VertexLayout::Attribute attribute, VertexLayout::Format format) {
+    using Format = VertexLayout::Format;
+
+    switch (attribute) {
+    case VertexLayout::Position:
+        return format == Format::Float3 || format == Format::Half4;
+    case VertexLayout::TexCoord:
+        return format == Format::None || format == Format::Float2 || format == Format::Half2 ||
+               format == Format::Unorm16x2;
+    case VertexLayout::Color:
+        return format == Format::None || format == Format::Float3 || format == Format::Half4 ||
+               format == Format::Unorm8x4;
+    default:
+        return format == Format::None || format == Format::Float3 || format == Format::Half4 ||
+               format == Format::Octahedral;
+    }
+}
+
+glm::vec2 octahedralEncode(glm::vec3 n) {
+    float sum = glm::abs(n.x) + glm::abs(n.y) + glm::abs(n.z);
+    if (sum <= 0.0f) {
+        return glm::vec2(0.0f);
+    }
+
+    n /= sum;
+    if (n.z >= 0.0f) {
+        return glm::vec2(n.x, n.y);
+    }
+    // Fold the lower half over the diagonals.
+    return glm::vec2((1.0f - glm::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                     (1.0f - glm::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+}
+
+// Writes one attribute value; components are given as a vec3 (texture coordinates use x and y).
+void packAttribute(VertexLayout::Format format, glm::vec3 value, uint8_t *out) {
+    using Format = VertexLayout::Format;
+
+    switch (format) {
+    case Format::Float2:
+        std::memcpy(out, &value, 2 * sizeof(float));
+        break;
+    case Format::Float3:
+        std::memcpy(out, &value, 3 * sizeof(float));
+        break;
+    case Format::Half4: {
+        glm::uint64 packed = glm::packHalf4x16(glm::vec4(value, 0.0f));
+        std::memcpy(out, &packed, sizeof(packed));
+        break;
+    }
+    case Format::Half2: {
+        glm::uint packed = glm::packHalf2x16(glm::vec2(value));
+        std::memcpy(out, &packed, sizeof(packed));
+        break;
+    }
+    case Format::Unorm16x2: {
+        glm::uint packed = glm::packUnorm2x16(glm::vec2(value));
+        std::memcpy(out, &packed, sizeof(packed));
+        break;
+    }
+    case Format::Octahedral: {
+        glm::uint packed = glm::packSnorm2x16(octahedralEncode(value));
+        std::memcpy(out, &packed, sizeof(packed));
+        break;
+    }
+    case Format::Unorm8x4: {
+        glm::uint packed = glm::packUnorm4x8(glm::vec4(value, 1.0f));
+        std::memcpy(out, &packed, sizeof(packed));
+        break;
+    }
+    case Format::None:
+        break;
+    }
+}
+
+} // namespace
+
+VertexLayout::VertexLayout() {
+    for (int i = 0; i < AttributeCount; i++) {
+        m_Formats[i] = c_FullFormats[i];
+    }
+    set(Position, Format::Float3);
+}
+
+bool VertexLayout::set(Attribute attribute, Format format) {
+    if (!fitsAttribute(attribute, format)) {
+        return false;
+    }
+    m_Formats[attribute] = format;
+
+    // Every format is a multiple of 4 bytes, so attributes stay aligned back to back.
+    m_Stride = 0;
+    for (int i = 0; i < AttributeCount; i++) {
+        m_Offsets[i] = m_Stride;
+        m_Stride += static_cast<uint32_t>(formatBytes(m_Formats[i]));
+    }
+    return true;
+}
+
+bool VertexLayout::isFull() const {
+    for (int i = 0; i < AttributeCount; i++) {
+        if (m_Formats[i] != c_FullFormats[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void VertexLayout::pack(const std::vector<Vertex> &vertices, size_t first, size_t count, uint8_t *out) const {
+    if (isFull()) {
+        std::memcpy(out, vertices.data() + first, count * sizeof(Vertex));
+        return;
+    }
+
+    for (size_t i = first; i < first + count; i++) {
+        const Vertex &vertex = vertices[i];
+        const glm::vec3 values[AttributeCount] = {vertex.position, vertex.normal,    glm::vec3(vertex.textCoord, 0.0f),
+                                                  vertex.tangent,  vertex.bitangent, vertex.color};
+
+        for (int k = 0; k < AttributeCount; k++) {
+            packAttribute(m_Formats[k], values[k], out + m_Offsets[k]);
+        }
+        out += m_Stride;
+    }
+}
+
+void VertexLayout::apply() const {
+    for (GLuint location = 0; location < AttributeCount; location++) {
+        const void *offset = reinterpret_cast<void *>(static_cast<uintptr_t>(m_Offsets[location]));
+        GLsizei stride = static_cast<GLsizei>(m_Stride);
+
+        switch (m_Formats[location]) {
+        case Format::None:
+            glDisableVertexAttribArray(location);
+            continue;
+        case Format::Float2:
+            glVertexAttribPointer(location, 2, GL_FLOAT, GL_FALSE, stride, offset);
+            break;
+        case Format::Float3:
+            glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride, offset);
+            break;
+        case Format::Half4:
+            glVertexAttribPointer(location, 3, GL_HALF_FLOAT, GL_FALSE, stride, offset);
+            break;
+        case Format::Half2:
+            glVertexAttribPointer(location, 2, GL_HALF_FLOAT, GL_FALSE, stride, offset);
+            break;
+        case Format::Unorm16x2:
+            glVertexAttribPointer(location, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, offset);
+            break;
+        case Format::Octahedral:
+            glVertexAttribPointer(location, 2, GL_SHORT, GL_TRUE, stride, offset);
+            break;
+        case Format::Unorm8x4:
+            glVertexAttribPointer(location, 3, GL_UNSIGNED_BYTE, GL_TRUE, stride, offset);
+            break;
+        }
+        glEnableVertexAttribArray(location);
+    }
+}
+
+VertexLayout VertexLayout::compact() {
+    VertexLayout layout;
+    layout.set(Normal, Format::Half4);
+    layout.set(TexCoord, Format::Half2);
+    layout.set(Tangent, Format::None);
+    layout.set(Bitangent, Format::None);
+    layout.set(Color, Format::None);
+    return layout;
+}
+
+size_t VertexLayout::formatBytes(Format format) {
+    switch (format) {
+    case Format::Float2:
+        return 8;
+    case Format::Float3:
+        return 12;
+    case Format::Half4:
+        return 8;
+    case Format::Half2:
+    case Format::Unorm16x2:
+    case Format::Octahedral:
+    case Format::Unorm8x4:
+        return 4;
+    case Format::None:
+        return 0;
+    }
+    return 0;
+}
+
+} // namespace Engine
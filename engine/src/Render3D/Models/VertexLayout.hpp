@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Vertex.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * How a mesh stores Vertex attributes in its vertex buffer. Each attribute
+ * keeps its shader location (its Attribute value) and can be dropped or
+ * stored in a narrower format; Mesh::setUp() packs the vertices to match.
+ *
+ * Every format except Octahedral is widened back to floats by the vertex
+ * fetch, so shaders do not change. Octahedral arrives as a vec2 and needs
+ * decoding, see shaders/lib/normal/octahedral.glsl. Dropped attributes read
+ * as the generic attribute value, (0, 0, 0) unless set.
+ */
+class VertexLayout {
+  public:
+    enum Attribute { Position, Normal, TexCoord, Tangent, Bitangent, Color, AttributeCount };
+
+    enum class Format {
+        None,
+        Float2,
+        Float3,
+        // Four half floats, the last one padding
+        Half4,
+        Half2,
+        // [0, 1] mapped to 16 bits, for texture coordinates that do not wrap
+        Unorm16x2,
+        // Unit vector folded onto an octahedron, two 16-bit snorms
+        Octahedral,
+        // Four bytes, for colors; alpha is always 1
+        Unorm8x4
+    };
+
+  private:
+    Format m_Formats[AttributeCount];
+    uint32_t m_Offsets[AttributeCount];
+    uint32_t m_Stride = 0;
+
+  public:
+    // Same as Vertex: every attribute as floats, 68 bytes.
+    VertexLayout();
+
+    /**
+     * Changes the format of one attribute. Returns false and changes
+     * nothing if the format cannot hold it, e.g. Octahedral for a color.
+     */
+    bool set(Attribute attribute, Format format);
+
+    Format getFormat(Attribute attribute) const { return m_Formats[attribute]; }
+    uint32_t getOffset(Attribute attribute) const { return m_Offsets[attribute]; }
+    uint32_t getStride() const { return m_Stride; }
+    bool has(Attribute attribute) const { return m_Formats[attribute] != Format::None; }
+
+    // True when the buffer is a plain copy of the Vertex array.
+    bool isFull() const;
+
+    // Writes count vertices from first on to out, getStride() bytes each.
+    void pack(const std::vector<Vertex> &vertices, size_t first, size_t count, uint8_t *out) const;
+
+    // Sets the attribute pointers of the bound vertex array for the bound buffer.
+    void apply() const;
+
+    /**
+     * Position and texture coordinate as floats and halves, normal as halves:
+     * 24 bytes, readable by any shader that does not need tangents or color.
+     */
+    static VertexLayout compact();
+
+    static size_t formatBytes(Format format);
+};
+
+} // namespace Engine
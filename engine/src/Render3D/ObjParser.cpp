@@ -0,0 +1,319 @@
+#include "ObjParser.hpp"
+
+#include "MappedFile.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+namespace Engine {
+
+namespace {
+
+bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+const char *skipBlanks(const char *p, const char *end) {
+    while (p < end && isBlank(*p)) {
+        p++;
+    }
+    return p;
+}
+
+// Reads up to count floats and returns how many were read; the rest are left as they are.
+int readFloats(const char *p, const char *end, float *values, int count) {
+    for (int i = 0; i < count; i++) {
+        p = skipBlanks(p, end);
+        if (p < end && *p == '+') {
+            p++;
+        }
+
+        auto result = std::from_chars(p, end, values[i]);
+        if (result.ec != std::errc()) {
+            return i;
+        }
+        p = result.ptr;
+    }
+    return count;
+}
+
+// Runs job(i) for i in [0, count), on the pool when there is one.
+void forEachChunk(JobPool *jobs, size_t count, const std::function<void(size_t)> &job) {
+    if (jobs == nullptr || count < 2) {
+        for (size_t i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+
+    JobPool::Batch batch;
+    for (size_t i = 0; i < count; i++) {
+        jobs->submit([&job, i](unsigned) { job(i); }, batch);
+    }
+    jobs->wait(batch);
+}
+
+} // namespace
+
+bool ObjParser::parse(const std::string &path) {
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "ObjParser: cannot open " << path << "\n";
+        return false;
+    }
+    file.adviseSequential();
+
+    parse(file.data(), file.data() + file.size(), nullptr);
+    return true;
+}
+
+bool ObjParser::parse(const std::string &path, JobPool &jobs) {
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "ObjParser: cannot open " << path << "\n";
+        return false;
+    }
+    file.adviseSequential();
+
+    parse(file.data(), file.data() + file.size(), &jobs);
+    return true;
+}
+
+void ObjParser::parse(const char *begin, const char *end, JobPool *jobs) {
+    m_Vertices.clear();
+    m_Stats = Stats();
+    m_Stats.bytes = static_cast<size_t>(end - begin);
+
+    // Chunks end right after a line break, so no line is split.
+    size_t chunkCount = jobs != nullptr ? std::max<size_t>(1, (m_Stats.bytes + m_ChunkBytes - 1) / m_ChunkBytes) : 1;
+    std::vector<Chunk> chunks(chunkCount);
+
+    const char *p = begin;
+    for (size_t i = 0; i < chunkCount; i++) {
+        const char *target = i + 1 == chunkCount ? end : std::max(p, begin + m_Stats.bytes / chunkCount * (i + 1));
+        const char *lineEnd = static_cast<const char *>(std::memchr(target, '\n', static_cast<size_t>(end - target)));
+
+        chunks[i].begin = p;
+        chunks[i].end = lineEnd != nullptr ? lineEnd + 1 : end;
+        p = chunks[i].end;
+    }
+
+    forEachChunk(jobs, chunkCount, [&chunks](size_t i) { parseChunk(chunks[i]); });
+
+    // Element counts before each chunk turn relative indices absolute.
+    size_t totals[3] = {0, 0, 0};
+    for (auto &chunk : chunks) {
+        size_t counts[3] = {chunk.positions.size(), chunk.texCoords.size(), chunk.normals.size()};
+        for (int k = 0; k < 3; k++) {
+            chunk.bases[k] = totals[k];
+            totals[k] += counts[k];
+        }
+    }
+
+    std::vector<glm::vec3> positions(totals[0]);
+    std::vector<glm::vec2> texCoords(totals[1]);
+    std::vector<glm::vec3> normals(totals[2]);
+
+    forEachChunk(jobs, chunkCount, [&](size_t i) {
+        Chunk &chunk = chunks[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.bases[0]);
+        std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), texCoords.begin() + chunk.bases[1]);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.bases[2]);
+        std::vector<glm::vec3>().swap(chunk.positions);
+        std::vector<glm::vec2>().swap(chunk.texCoords);
+        std::vector<glm::vec3>().swap(chunk.normals);
+
+        resolveChunk(chunk, totals);
+    });
+
+    size_t vertexCount = 0;
+    for (auto &chunk : chunks) {
+        chunk.vertexBase = vertexCount;
+        vertexCount += chunk.corners.size();
+
+        m_Stats.faces += chunk.faces;
+        m_Stats.skippedFaces += chunk.skippedFaces;
+        m_Stats.skippedTriangles += chunk.skippedTriangles;
+    }
+
+    m_Vertices.resize(vertexCount);
+    forEachChunk(jobs, chunkCount, [&](size_t i) { emitChunk(chunks[i], positions, texCoords, normals); });
+
+    m_Stats.chunks = chunkCount;
+    m_Stats.positions = totals[0];
+    m_Stats.texCoords = totals[1];
+    m_Stats.normals = totals[2];
+    m_Stats.triangles = vertexCount / 3;
+}
+
+void ObjParser::parseChunk(Chunk &chunk) {
+    std::vector<Corner> face;
+    const char *p = chunk.begin;
+
+    while (p < chunk.end) {
+        p = skipBlanks(p, chunk.end);
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', static_cast<size_t>(chunk.end - p)));
+        if (lineEnd == nullptr) {
+            lineEnd = chunk.end;
+        }
+
+        size_t length = static_cast<size_t>(lineEnd - p);
+        if (length >= 2 && p[0] == 'v' && isBlank(p[1])) {
+            // Elements are kept even when malformed, so later indices still line up.
+            glm::vec3 position(0.0f);
+            readFloats(p + 2, lineEnd, &position.x, 3);
+            chunk.positions.push_back(position);
+        } else if (length >= 3 && p[0] == 'v' && p[1] == 't' && isBlank(p[2])) {
+            glm::vec2 texCoord(0.0f);
+            readFloats(p + 3, lineEnd, &texCoord.x, 2);
+            chunk.texCoords.push_back(texCoord);
+        } else if (length >= 3 && p[0] == 'v' && p[1] == 'n' && isBlank(p[2])) {
+            glm::vec3 normal(0.0f);
+            readFloats(p + 3, lineEnd, &normal.x, 3);
+            chunk.normals.push_back(normal);
+        } else if (length >= 2 && p[0] == 'f' && isBlank(p[1])) {
+            parseFace(p + 2, lineEnd, chunk, face);
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+const char *ObjParser::parseFace(const char *p, const char *end, Chunk &chunk, std::vector<Corner> &face) {
+    const size_t counts[3] = {chunk.positions.size(), chunk.texCoords.size(), chunk.normals.size()};
+    bool valid = true;
+    face.clear();
+    chunk.faces++;
+
+    while (valid) {
+        p = skipBlanks(p, end);
+        if (p >= end || *p == '#') {
+            break;
+        }
+
+        // p, p/t, p//n or p/t/n; 0 stands for an absent index
+        int64_t values[3] = {0, 0, 0};
+        for (int k = 0; k < 3 && valid; k++) {
+            if (k > 0) {
+                if (p >= end || *p != '/') {
+                    break;
+                }
+                p++;
+                if (k == 1 && p < end && *p == '/') {
+                    continue;
+                }
+            }
+
+            auto result = std::from_chars(p, end, values[k]);
+            valid = result.ec == std::errc() && values[k] != 0;
+            p = result.ptr;
+        }
+
+        if (!valid || (p < end && !isBlank(*p))) {
+            valid = false;
+            break;
+        }
+
+        Corner corner;
+        corner.relative = 0;
+        for (int k = 0; k < 3; k++) {
+            int64_t value = values[k];
+            if (value == 0) {
+                corner.index[k] = c_Missing;
+            } else if (value > 0) {
+                // Absolute and 1-based
+                valid = valid && value <= INT32_MAX;
+                corner.index[k] = static_cast<int32_t>(value - 1);
+            } else {
+                // Counted back from the last element read so far, which may lie in an earlier chunk
+                int64_t local = static_cast<int64_t>(counts[k]) + value;
+                valid = valid && local > INT32_MIN;
+                corner.index[k] = static_cast<int32_t>(local);
+                corner.relative |= static_cast<uint8_t>(1u << k);
+            }
+        }
+        face.push_back(corner);
+    }
+
+    if (!valid || face.size() < 3) {
+        chunk.skippedFaces++;
+        return p;
+    }
+
+    for (size_t i = 1; i + 1 < face.size(); i++) {
+        chunk.corners.push_back(face[0]);
+        chunk.corners.push_back(face[i]);
+        chunk.corners.push_back(face[i + 1]);
+    }
+    return p;
+}
+
+void ObjParser::resolveChunk(Chunk &chunk, const size_t totals[3]) {
+    size_t kept = 0;
+
+    for (size_t triangle = 0; triangle < chunk.corners.size(); triangle += 3) {
+        Corner corners[3] = {chunk.corners[triangle], chunk.corners[triangle + 1], chunk.corners[triangle + 2]};
+        bool valid = true;
+
+        for (auto &corner : corners) {
+            for (int k = 0; k < 3; k++) {
+                if (corner.index[k] == c_Missing) {
+                    valid = valid && k != 0;
+                    continue;
+                }
+
+                int64_t index = corner.index[k];
+                if (corner.relative & (1u << k)) {
+                    index += static_cast<int64_t>(chunk.bases[k]);
+                }
+                valid = valid && index >= 0 && index < static_cast<int64_t>(totals[k]);
+                corner.index[k] = static_cast<int32_t>(index);
+            }
+            corner.relative = 0;
+        }
+
+        if (valid) {
+            std::copy(corners, corners + 3, chunk.corners.begin() + kept);
+            kept += 3;
+        } else {
+            chunk.skippedTriangles++;
+        }
+    }
+
+    chunk.corners.resize(kept);
+}
+
+void ObjParser::emitChunk(const Chunk &chunk, const std::vector<glm::vec3> &positions,
+                          const std::vector<glm::vec2> &texCoords, const std::vector<glm::vec3> &normals) {
+    Vertex *out = m_Vertices.data() + chunk.vertexBase;
+
+    for (size_t triangle = 0; triangle < chunk.corners.size(); triangle += 3) {
+        const Corner *corners = &chunk.corners[triangle];
+        glm::vec3 P[3] = {positions[static_cast<size_t>(corners[0].index[0])],
+                          positions[static_cast<size_t>(corners[1].index[0])],
+                          positions[static_cast<size_t>(corners[2].index[0])]};
+
+        glm::vec3 faceNormal(0.0f);
+        glm::vec3 cross = glm::cross(P[1] - P[0], P[2] - P[0]);
+        float length = glm::length(cross);
+        if (length > 0.0f) {
+            faceNormal = cross / length;
+        }
+
+        for (int k = 0; k < 3; k++) {
+            const Corner &corner = corners[k];
+            glm::vec2 texCoord = corner.index[1] == c_Missing ? glm::vec2(0.0f)
+                                                               : texCoords[static_cast<size_t>(corner.index[1])];
+            glm::vec3 normal = corner.index[2] == c_Missing ? faceNormal
+                                                             : normals[static_cast<size_t>(corner.index[2])];
+
+            out[triangle + static_cast<size_t>(k)] = Vertex(P[k], normal, texCoord, glm::vec3(1.0f, 0.0f, 0.0f),
+                                                            glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f));
+        }
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "JobPool.hpp"
+#include "Vertex.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * Wavefront OBJ geometry reader. The file is memory-mapped and numbers are
+ * read with std::from_chars, so no streams or locales are involved. Large
+ * inputs are cut into chunks at line breaks and parsed in parallel.
+ *
+ * Faces may use any of the v, v/t, v//n and v/t/n corner forms, positive or
+ * negative (relative) indices, and any number of corners; polygons are fan
+ * triangulated. The result is a triangle soup, three vertices per triangle.
+ * Faces without normals get their flat face normal. Malformed faces and
+ * triangles referring to missing elements are skipped and counted.
+ */
+class ObjParser {
+  public:
+    struct Stats {
+        size_t bytes = 0;
+        size_t chunks = 0;
+        size_t positions = 0;
+        size_t texCoords = 0;
+        size_t normals = 0;
+        size_t faces = 0;
+        size_t triangles = 0;
+        // Malformed faces, and triangles referring to elements the file does not have
+        size_t skippedFaces = 0;
+        size_t skippedTriangles = 0;
+    };
+
+  private:
+    // Element indices of one triangle corner. An index is absolute, or
+    // relative to the first element of its chunk when the matching bit of
+    // relative is set; c_Missing marks an absent one.
+    struct Corner {
+        int32_t index[3];
+        uint8_t relative;
+    };
+
+    struct Chunk {
+        const char *begin;
+        const char *end;
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::vector<glm::vec3> normals;
+        std::vector<Corner> corners;
+
+        size_t faces = 0;
+        size_t skippedFaces = 0;
+        size_t skippedTriangles = 0;
+
+        // Offsets of this chunk's elements and output vertices in the whole file
+        size_t bases[3] = {0, 0, 0};
+        size_t vertexBase = 0;
+    };
+
+    static constexpr int32_t c_Missing = INT32_MIN;
+
+    std::vector<Vertex> m_Vertices;
+    Stats m_Stats;
+    size_t m_ChunkBytes = 8 << 20;
+
+  public:
+    // Parses on the calling thread; the pool overload parses chunks of large files in parallel.
+    bool parse(const std::string &path);
+    bool parse(const std::string &path, JobPool &jobs);
+
+    // Parses text that is already in memory.
+    void parse(const char *begin, const char *end, JobPool *jobs = nullptr);
+
+    std::vector<Vertex> &getVertices() { return m_Vertices; }
+    const Stats &getStats() const { return m_Stats; }
+
+    // With a pool, text up to this size is still parsed in one piece on the calling thread.
+    void setChunkBytes(size_t bytes) { m_ChunkBytes = bytes; }
+    size_t getChunkBytes() const { return m_ChunkBytes; }
+
+  private:
+    static void parseChunk(Chunk &chunk);
+    static const char *parseFace(const char *p, const char *end, Chunk &chunk, std::vector<Corner> &face);
+    static void resolveChunk(Chunk &chunk, const size_t totals[3]);
+
+    void emitChunk(const Chunk &chunk, const std::vector<glm::vec3> &positions,
+                   const std::vector<glm::vec2> &texCoords, const std::vector<glm::vec3> &normals);
+};
+
+} // namespace Engine
@@ -12,6 +12,8 @@
 #include "stb_image.hpp"
 #pragma GCC diagnostic pop
 
+#include "GpuResources.hpp"
+
 #include "glad/glad.h"
 
 #include <cassert>
@@ -44,7 +46,7 @@ Texture TextureLoader::loadTexture(const std::string &path) {
         dataFormat = GL_RED;
     }
 
-    glGenTextures(1, &texture.id);
+    texture.id = GpuResources::create(GpuResources::Texture);
     glBindTexture(GL_TEXTURE_2D, texture.id);
 
     GLint mipmapLevel = 0;
@@ -86,6 +88,8 @@ Texture TextureLoader::loadTexture(const std::string &path) {
     }
     texture.dataType = Texture::DataType::UNSIGNED_BYTE;
 
+    // The mipmap chain adds a third to the base level.
+    GpuResources::setBytes(GpuResources::Texture, texture.id, texture.getBytes() * 4 / 3);
     return texture;
 }
 
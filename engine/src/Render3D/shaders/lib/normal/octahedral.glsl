@@ -0,0 +1,22 @@
+/////////////////////////////////////////////////////////////
+/////////////////// OCTAHEDRAL NORMALS //////////////////////
+/////////////////////////////////////////////////////////////
+
+// Decodes a vector stored with VertexLayout::Format::Octahedral; declare
+// the attribute as vec2 and pass it here.
+
+/////////////////////////////////////////////////////////////
+/////////////////////// DECLARATION /////////////////////////
+/////////////////////////////////////////////////////////////
+vec3 octahedralDecode(vec2 encoded);
+
+/////////////////////////////////////////////////////////////
+////////////////////////// MAIN /////////////////////////////
+/////////////////////////////////////////////////////////////
+vec3 octahedralDecode(vec2 encoded) {
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -fold : fold;
+    n.y += n.y >= 0.0 ? -fold : fold;
+    return normalize(n);
+}